@@ -7,6 +7,7 @@
 #include "SharedConfig.h"
 #include <SDL_stdinc.h>
 #include <string>
+#include <cstddef>
 
 namespace AM
 {
@@ -44,6 +45,15 @@ public:
     static constexpr double SERVER_TIMEOUT_S{
         SharedConfig::NETWORK_TICK_TIMESTEP_S * 2};
 
+    //-------------------------------------------------------------------------
+    // Tile Map
+    //-------------------------------------------------------------------------
+    /** How much memory the tile map's resident chunks are allowed to use.
+        When we go over this, chunks far from the player are evicted (they'll
+        be re-requested from the server if we come back in range). */
+    static constexpr std::size_t RESIDENT_CHUNK_MEMORY_CAP_BYTES{16 * 1024
+                                                                 * 1024};
+
     //-------------------------------------------------------------------------
     // Renderer, User Interface
     //-------------------------------------------------------------------------
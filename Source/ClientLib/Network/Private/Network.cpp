@@ -28,6 +28,9 @@ Network::Network()
 , headerRecBuffer(SERVER_HEADER_SIZE)
 , batchRecBuffer(SharedConfig::MAX_BATCH_SIZE)
 , decompressedBatchRecBuffer(SharedConfig::MAX_BATCH_SIZE)
+, fragmentBuffer{}
+, fragmentMessageType{MessageType::NotSet}
+, fragmentTotalSize{0}
 , netstatsLoggingEnabled{true}
 , ticksSinceNetstatsLog{0}
 {
@@ -68,6 +71,7 @@ void Network::disconnect()
         receiveThreadObj.join();
     }
     server = nullptr;
+    fragmentBuffer.clear();
     adjustmentIteration = 0;
     isApplyingTickAdjustment = false;
     messagesSentSinceTick = 0;
@@ -272,10 +276,15 @@ void Network::processBatch()
             Uint16 messageSize{ByteTools::read16(
                 &(bufferToUse[bufferIndex + MessageHeaderIndex::Size]))};
 
-            messageProcessor.processReceivedMessage(
-                messageType,
-                &(bufferToUse[bufferIndex + MessageHeaderIndex::MessageStart]),
-                messageSize);
+            Uint8* messageBuffer{
+                &(bufferToUse[bufferIndex + MessageHeaderIndex::MessageStart])};
+            if (messageType == MessageType::MessageFragment) {
+                processFragment(messageBuffer, messageSize);
+            }
+            else {
+                messageProcessor.processReceivedMessage(
+                    messageType, messageBuffer, messageSize);
+            }
 
             bufferIndex += MESSAGE_HEADER_SIZE + messageSize;
             AM_ASSERT((bufferIndex <= batchSize),
@@ -291,6 +300,55 @@ void Network::processBatch()
     NetworkStats::recordBytesReceived(bytesReceived);
 }
 
+void Network::processFragment(Uint8* messageBuffer, Uint16 messageSize)
+{
+    if (messageSize < MESSAGE_FRAGMENT_HEADER_SIZE) {
+        LOG_FATAL("Received a malformed message fragment.");
+    }
+
+    MessageType messageType{static_cast<MessageType>(
+        messageBuffer[MessageFragmentIndex::MessageType])};
+    Uint32 totalSize{
+        ByteTools::read32(&(messageBuffer[MessageFragmentIndex::TotalSize]))};
+
+    // If this is the first fragment of a message, start a new one.
+    if (fragmentBuffer.size() == 0) {
+        if (totalSize > SharedConfig::MAX_MESSAGE_SIZE) {
+            LOG_FATAL("Fragmented message is too large. Size: %u, max: %u",
+                      totalSize, SharedConfig::MAX_MESSAGE_SIZE);
+        }
+        fragmentMessageType = messageType;
+        fragmentTotalSize = totalSize;
+        fragmentBuffer.reserve(totalSize);
+    }
+    else if ((messageType != fragmentMessageType)
+             || (totalSize != fragmentTotalSize)) {
+        // Fragments are always sent back to back, so this means we missed
+        // part of a message.
+        LOG_FATAL("Received a fragment from an unexpected message.");
+    }
+
+    // Append the fragment's bytes.
+    std::size_t fragmentSize{messageSize - MESSAGE_FRAGMENT_HEADER_SIZE};
+    if ((fragmentBuffer.size() + fragmentSize) > fragmentTotalSize) {
+        LOG_FATAL("Received more fragment bytes than expected.");
+    }
+    Uint8* fragmentStart{&(messageBuffer[MessageFragmentIndex::FragmentStart])};
+    fragmentBuffer.insert(fragmentBuffer.end(), fragmentStart,
+                          (fragmentStart + fragmentSize));
+
+    // If we have the whole message, process it.
+    if (fragmentBuffer.size() == fragmentTotalSize) {
+        messageProcessor.processReceivedMessage(
+            fragmentMessageType, fragmentBuffer.data(),
+            static_cast<unsigned int>(fragmentTotalSize));
+
+        // Note: clear() keeps the capacity, so later large messages are
+        //       cheaper to reassemble.
+        fragmentBuffer.clear();
+    }
+}
+
 void Network::adjustIfNeeded(Sint8 receivedTickAdj, Uint8 receivedAdjIteration)
 {
     if (receivedTickAdj != 0) {
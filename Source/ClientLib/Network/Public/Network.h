@@ -145,6 +145,12 @@ private:
      */
     void processBatch();
 
+    /**
+     * Adds the given MessageFragment's bytes to fragmentBuffer. If that
+     * completes the message, passes it to messageProcessor.
+     */
+    void processFragment(Uint8* messageBuffer, Uint16 messageSize);
+
     /**
      * Checks if we need to process the received adjustment, does so if
      * necessary.
@@ -199,6 +205,15 @@ private:
         processing. */
     BinaryBuffer decompressedBatchRecBuffer;
 
+    /** Holds the fragments of a message that was too large for a single
+        batch, while we reassemble it. Empty if we aren't in the middle of a
+        fragmented message. */
+    BinaryBuffer fragmentBuffer;
+    /** The type of the message in fragmentBuffer. */
+    MessageType fragmentMessageType;
+    /** The total payload size of the message in fragmentBuffer. */
+    std::size_t fragmentTotalSize;
+
     /** The number of seconds we'll wait before logging our network
         statistics. */
     static constexpr unsigned int SECONDS_TILL_STATS_DUMP{5};
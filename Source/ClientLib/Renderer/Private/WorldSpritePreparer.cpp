@@ -91,15 +91,16 @@ void WorldSpritePreparer::gatherSpriteInfo(const Camera& camera, double alpha)
             const Tile& tile{tileMap.getTile(x, y)};
 
             // Push all of this tile's sprites into the appropriate vector.
-            for (const Tile::SpriteLayer& layer : tile.spriteLayers) {
+            for (std::size_t i = 0; i < tile.layerCount; ++i) {
                 // If the layer is empty, skip it.
-                if (layer.sprite.numericID == EMPTY_SPRITE_ID) {
+                int spriteID{tile.spriteIDs[i]};
+                if (spriteID == EMPTY_SPRITE_ID) {
                     continue;
                 }
 
                 // Get iso screen extent for this sprite.
                 const SpriteRenderData& renderData{
-                    spriteData.getRenderData(layer.sprite.numericID)};
+                    spriteData.getRenderData(spriteID)};
                 SDL_Rect screenExtent{ClientTransforms::tileToScreenExtent(
                     {x, y}, renderData, camera)};
 
@@ -109,14 +110,17 @@ void WorldSpritePreparer::gatherSpriteInfo(const Camera& camera, double alpha)
                 }
 
                 // If this sprite has a bounding box, push it to be sorted.
-                if (layer.sprite.hasBoundingBox) {
-                    spritesToSort.emplace_back(&(layer.sprite),
-                                               layer.worldBounds, screenExtent);
+                const Sprite& sprite{spriteData.get(spriteID)};
+                if (sprite.hasBoundingBox) {
+                    BoundingBox worldBounds{Transforms::modelToWorldTile(
+                        sprite.modelBounds, {x, y})};
+                    spritesToSort.emplace_back(&sprite, worldBounds,
+                                               screenExtent);
                 }
                 else {
                     // No bounding box, push it straight into the sorted
                     // sprites vector.
-                    sortedSprites.emplace_back(&(layer.sprite), BoundingBox{},
+                    sortedSprites.emplace_back(&sprite, BoundingBox{},
                                                screenExtent);
                 }
             }
@@ -11,6 +11,7 @@
 #include "SharedConfig.h"
 #include "Config.h"
 #include "Log.h"
+#include <algorithm>
 #include <memory>
 
 namespace AM
@@ -22,6 +23,7 @@ ChunkUpdateSystem::ChunkUpdateSystem(Simulation& inSimulation, World& inWorld,
 : simulation{inSimulation}
 , world{inWorld}
 , network{inNetwork}
+, receivedChunks{}
 , chunkUpdateQueue{network.getEventDispatcher()}
 {
 }
@@ -33,6 +35,11 @@ void ChunkUpdateSystem::updateChunks()
 
     // Process any received chunk updates.
     receiveAndApplyUpdates();
+
+    // If we're holding too many chunks, drop the far ones.
+    if (world.tileMap.getResidentChunkCount() > MAX_RESIDENT_CHUNKS) {
+        evictFarChunks();
+    }
 }
 
 void ChunkUpdateSystem::requestNeededUpdates()
@@ -136,34 +143,66 @@ void ChunkUpdateSystem::receiveAndApplyUpdates()
 
 void ChunkUpdateSystem::applyChunkSnapshot(const ChunkWireSnapshot& chunk)
 {
-    // Iterate through the chunk snapshot's linear tile array, adding the tiles
-    // to our map.
-    int tileIndex{0};
-    for (unsigned int tileY = 0; tileY < SharedConfig::CHUNK_WIDTH; ++tileY) {
-        for (unsigned int tileX = 0; tileX < SharedConfig::CHUNK_WIDTH;
-             ++tileX) {
-            // Calculate where this tile is.
-            unsigned int currentTileX{
-                ((chunk.x * SharedConfig::CHUNK_WIDTH) + tileX)};
-            unsigned int currentTileY{
-                ((chunk.y * SharedConfig::CHUNK_WIDTH) + tileY)};
-
-            // Clear the tile.
-            world.tileMap.clearTile(currentTileX, currentTileY);
-
-            // Copy all of the snapshot tile's sprite layers to our map tile.
-            const TileSnapshot& tileSnapshot{chunk.tiles[tileIndex]};
-            unsigned int layerIndex{0};
-            for (Uint8 paletteID : tileSnapshot.spriteLayers) {
-                // Add the sprite layer to the tile.
-                world.tileMap.setTileSpriteLayer(currentTileX, currentTileY,
-                                                 layerIndex++,
-                                                 chunk.palette[paletteID]);
+    // Copy all of the snapshot's sprite layers into a chunk.
+    Chunk newChunk{};
+    for (unsigned int i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
+        const TileSnapshot& tileSnapshot{chunk.tiles[i]};
+        Tile& tile{newChunk.tiles[i]};
+        for (Uint8 paletteID : tileSnapshot.spriteLayers) {
+            if (tile.layerCount == SharedConfig::MAX_TILE_LAYERS) {
+                LOG_ERROR("Received tile with too many layers.");
+                break;
             }
+            tile.spriteIDs[tile.layerCount++] = chunk.palette[paletteID];
+        }
+    }
 
-            // Increment to the next linear index.
-            tileIndex++;
+    // Replace the chunk in our map.
+    ChunkPosition chunkPosition{chunk.x, chunk.y};
+    if (!(world.tileMap.isChunkResident(chunkPosition))) {
+        receivedChunks.push_back(chunkPosition);
+    }
+    world.tileMap.setChunk(chunkPosition, newChunk);
+}
+
+void ChunkUpdateSystem::evictFarChunks()
+{
+    // Remove any chunks that are no longer resident (or no longer in the
+    // map, if it was cleared).
+    TileMap& tileMap{world.tileMap};
+    const ChunkExtent& mapChunkExtent{tileMap.getChunkExtent()};
+    std::erase_if(receivedChunks, [&](const ChunkPosition& chunkPosition) {
+        return !(mapChunkExtent.containsPosition(chunkPosition))
+               || !(tileMap.isChunkResident(chunkPosition));
+    });
+
+    // Sort the chunks so that the furthest from the player are at the end.
+    ChunkPosition centerChunk{
+        world.registry.get<Position>(world.playerEntity).asChunkPosition()};
+    std::sort(receivedChunks.begin(), receivedChunks.end(),
+              [&centerChunk](const ChunkPosition& lhs,
+                             const ChunkPosition& rhs) {
+                  int lhsX{lhs.x - centerChunk.x};
+                  int lhsY{lhs.y - centerChunk.y};
+                  int rhsX{rhs.x - centerChunk.x};
+                  int rhsY{rhs.y - centerChunk.y};
+                  return ((lhsX * lhsX) + (lhsY * lhsY))
+                         < ((rhsX * rhsX) + (rhsY * rhsY));
+              });
+
+    // Evict the furthest chunks until we're under the cap.
+    // Note: This is hardcoded to assume the in-range chunks are all chunks
+    //       directly surrounding the player's chunk.
+    ChunkExtent inRangeExtent{(centerChunk.x - 1), (centerChunk.y - 1), 3, 3};
+    while ((tileMap.getResidentChunkCount() > MAX_RESIDENT_CHUNKS)
+           && (receivedChunks.size() > 0)) {
+        const ChunkPosition& chunkPosition{receivedChunks.back()};
+        if (inRangeExtent.containsPosition(chunkPosition)) {
+            break;
         }
+
+        tileMap.releaseChunk(chunkPosition);
+        receivedChunks.pop_back();
     }
 }
 
@@ -10,6 +10,7 @@
 #include "PreviousPosition.h"
 #include "Velocity.h"
 #include "Input.h"
+#include "IsMoving.h"
 #include "Rotation.h"
 #include "Collision.h"
 #include "InputHistory.h"
@@ -37,6 +38,7 @@ NpcMovementSystem::NpcMovementSystem(Simulation& inSimulation, World& inWorld,
 , spriteData{inSpriteData}
 , lastReceivedTick{0}
 , lastProcessedTick{0}
+, movementBatch{}
 {
 }
 
@@ -85,9 +87,10 @@ void NpcMovementSystem::updateNpcs()
     // log it.
     if (!updated && (lastReceivedTick != 0)
         && (lastProcessedTick < desiredTick)) {
-        LOG_INFO("Tick passed with no npc update. last: %u, desired: %u, "
-                 "queueSize: %u",
-                 lastProcessedTick, desiredTick, movementUpdateQueue.size());
+        LOG_INFO_RATE_LIMITED("Tick passed with no npc update. last: %u, "
+                              "desired: %u, queueSize: %u",
+                              lastProcessedTick, desiredTick,
+                              movementUpdateQueue.size());
     }
 }
 
@@ -163,30 +166,44 @@ void NpcMovementSystem::handleUpdate(
 
 void NpcMovementSystem::moveAllNpcs()
 {
-    auto group = world.registry.group<Input, Position, PreviousPosition,
-                                      Velocity, Rotation, Collision>(
+    // Gather all NPCs that are flagged as moving.
+    // Note: Idle NPCs aren't flagged, so they cost nothing here.
+    entt::registry& registry{world.registry};
+    auto group = registry.group<Input, Position, PreviousPosition, Velocity,
+                                Rotation, Collision>(
         {}, entt::exclude<InputHistory>);
-    for (entt::entity entity : group) {
-        auto [input, position, previousPosition, velocity, rotation, collision]
-            = group.get<Input, Position, PreviousPosition, Velocity, Rotation,
+    auto movingView = registry.view<IsMoving>();
+    movementBatch.clear();
+    for (entt::entity entity : movingView) {
+        auto [input, position, velocity, rotation]
+            = group.get<Input, Position, Velocity, Rotation>(entity);
+        movementBatch.push(entity, input, position, velocity, rotation);
+    }
+
+    // Update their velocities, positions, and rotations, based on their
+    // current inputs.
+    MovementHelpers::updateBatch(movementBatch,
+                                 SharedConfig::SIM_TICK_TIMESTEP_S);
+
+    // Apply the results.
+    for (std::size_t i = 0; i < movementBatch.size(); ++i) {
+        entt::entity entity{movementBatch.entities[i]};
+        auto [position, previousPosition, velocity, rotation, collision]
+            = group.get<Position, PreviousPosition, Velocity, Rotation,
                         Collision>(entity);
 
         // Save their old position.
         previousPosition = position;
 
-        // Update their velocity for this tick, based on their current inputs.
-        velocity = MovementHelpers::updateVelocity(
-            velocity, input.inputStates, SharedConfig::SIM_TICK_TIMESTEP_S);
-
-        // Calculate their desired position, using the new velocity.
-        Position desiredPosition{position};
-        desiredPosition = MovementHelpers::updatePosition(
-            desiredPosition, velocity, SharedConfig::SIM_TICK_TIMESTEP_S);
-
-        // Update the direction they're facing, based on their current inputs.
-        rotation = MovementHelpers::updateRotation(rotation, input.inputStates);
+        velocity.x = movementBatch.velocityXs[i];
+        velocity.y = movementBatch.velocityYs[i];
+        rotation.direction = static_cast<Rotation::Direction>(
+            movementBatch.directions[i]);
 
         // If they're trying to move, resolve collisions.
+        Position desiredPosition{position};
+        desiredPosition.x = movementBatch.positionXs[i];
+        desiredPosition.y = movementBatch.positionYs[i];
         if (desiredPosition != position) {
             // Calculate a new bounding box to match their desired position.
             BoundingBox desiredBounds{Transforms::modelToWorldCentered(
@@ -203,6 +220,12 @@ void NpcMovementSystem::moveAllNpcs()
                          - collision.worldBounds.getMinPosition());
             collision.worldBounds = resolvedBounds;
         }
+
+        // If they've come to rest, stop processing them.
+        if ((position == previousPosition) && (velocity.x == 0)
+            && (velocity.y == 0)) {
+            registry.remove<IsMoving>(entity);
+        }
     }
 }
 
@@ -254,6 +277,11 @@ void NpcMovementSystem::applyUpdateMessage(
         // Move their collision box to their new position.
         collision.worldBounds
             = Transforms::modelToWorldCentered(collision.modelBounds, position);
+
+        // Flag that their movement needs to be processed.
+        // Note: Even if they're now idle, we need to process them once to
+        //       bring their previous position up to date.
+        registry.emplace_or_replace<IsMoving>(entity);
     }
 }
 
@@ -61,9 +61,19 @@ void ServerConnectionSystem::processConnectionEvents()
         // Wait for a connection response from the server.
         ConnectionResponse connectionResponse;
         if (connectionResponseQueue.pop(connectionResponse)) {
-            initSimState(connectionResponse);
-            connectionState = ConnectionState::Connected;
-            world.worldSignals.simulationStarted.publish();
+            // If we're in the server's join queue, keep waiting.
+            // Note: The server periodically updates us on our position, so
+            //       we restart the timeout with each update.
+            if (connectionResponse.queuePosition != 0) {
+                LOG_INFO("Waiting in the server's join queue. Position: %u",
+                         connectionResponse.queuePosition);
+                connectionAttemptTimer.reset();
+            }
+            else {
+                initSimState(connectionResponse);
+                connectionState = ConnectionState::Connected;
+                world.worldSignals.simulationStarted.publish();
+            }
         }
 
         // If we've timed out, send a failure signal.
@@ -29,8 +29,10 @@ TileMap::TileMap(SpriteData& inSpriteData)
 
         // Fill every tile with a ground layer.
         const Sprite& ground{spriteData.get("test_6")};
-        for (Tile& tile : tiles) {
-            tile.spriteLayers.emplace_back(ground, BoundingBox{});
+        for (int x = tileExtent.x; x <= tileExtent.xMax(); ++x) {
+            for (int y = tileExtent.y; y <= tileExtent.yMax(); ++y) {
+                setTileSpriteLayer(x, y, 0, ground);
+            }
         }
 
         // Add some rugs to layer 1.
@@ -67,8 +69,8 @@ void TileMap::setMapSize(unsigned int inMapXLengthChunks,
     tileExtent.xLength = (chunkExtent.xLength * SharedConfig::CHUNK_WIDTH);
     tileExtent.yLength = (chunkExtent.yLength * SharedConfig::CHUNK_WIDTH);
 
-    // Resize the tiles vector to fit the map.
-    tiles.resize(tileExtent.xLength * tileExtent.yLength);
+    // Allocate the chunks that make up the map.
+    allocateChunks();
 }
 
 } // End namespace Client
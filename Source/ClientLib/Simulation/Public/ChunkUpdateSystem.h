@@ -3,7 +3,10 @@
 #include "QueuedEvents.h"
 #include "ChunkUpdate.h"
 #include "ChunkPosition.h"
+#include "Chunk.h"
+#include "Config.h"
 #include <SDL_stdinc.h>
+#include <vector>
 
 namespace AM
 {
@@ -64,6 +67,18 @@ private:
      */
     void applyChunkSnapshot(const ChunkWireSnapshot& chunk);
 
+    /**
+     * If our resident chunks are over the memory cap, evicts the chunks that
+     * are furthest from the player until we're back under it.
+     * Chunks in range of the player are never evicted.
+     */
+    void evictFarChunks();
+
+    /** The maximum number of chunks that we'll keep resident, derived from
+        Config::RESIDENT_CHUNK_MEMORY_CAP_BYTES. */
+    static constexpr std::size_t MAX_RESIDENT_CHUNKS{
+        Config::RESIDENT_CHUNK_MEMORY_CAP_BYTES / sizeof(Chunk)};
+
     /** Used to get the current tick. */
     Simulation& simulation;
     /** Used to access the player entity and components. */
@@ -71,6 +86,10 @@ private:
     /** Used to send chunk update request messages. */
     Network& network;
 
+    /** The chunks that we've received from the server, which may be
+        evicted. */
+    std::vector<ChunkPosition> receivedChunks;
+
     EventQueue<std::shared_ptr<const ChunkUpdate>> chunkUpdateQueue;
 };
 
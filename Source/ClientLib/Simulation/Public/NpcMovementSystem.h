@@ -3,6 +3,7 @@
 #include "ClientNetworkDefs.h"
 #include "NetworkDefs.h"
 #include "QueuedEvents.h"
+#include "MovementBatch.h"
 #include <queue>
 
 namespace AM
@@ -92,6 +93,10 @@ private:
 
     /** The last tick that we processed update data for. */
     Uint32 lastProcessedTick;
+
+    /** Scratch storage for the moving NPCs' state. Kept as a member so its
+        allocations are re-used between ticks. */
+    MovementBatch movementBatch;
 };
 
 } // namespace Client
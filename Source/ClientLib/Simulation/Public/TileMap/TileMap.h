@@ -25,7 +25,7 @@ public:
     TileMap(SpriteData& inSpriteData);
 
     /**
-     * Sets the size of the map and resizes the tiles vector.
+     * Sets the size of the map and allocates its chunks.
      */
     void setMapSize(unsigned int inMapXLengthChunks,
                     unsigned int inMapYLengthChunks);
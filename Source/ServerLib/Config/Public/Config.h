@@ -64,9 +64,77 @@ public:
     static constexpr float SPAWN_POINT_GROUP_OFFSET_X{0};
     static constexpr float SPAWN_POINT_GROUP_OFFSET_Y{400};
 
-    /** How often the world's tile map should be saved, in seconds. */
+    /** How often the world's tile map should be fully saved, in seconds.
+        Full saves fold the journal into TileMap.bin. */
     static constexpr float MAP_SAVE_PERIOD_S{60 * 15};
 
+    /** How often chunks that changed should be appended to the tile map's
+        journal, in seconds. This bounds how much map data we can lose if
+        the server crashes. */
+    static constexpr float MAP_JOURNAL_PERIOD_S{5};
+
+    /** The max number of newly connected clients that we'll spawn into the
+        sim per tick. When more clients connect at once (e.g. everyone
+        reconnecting after a restart), the rest wait in a join queue so that
+        the tick doesn't spike for the clients that are already online. */
+    static constexpr unsigned int MAX_JOINS_PER_TICK{4};
+
+    /** How often clients in the join queue are sent their position, in
+        seconds. Must be less than the client's connection response timeout. */
+    static constexpr double JOIN_QUEUE_UPDATE_PERIOD_S{1};
+
+    /** How often join latency stats are logged, in seconds. Stats are only
+        logged if any clients joined during the period. */
+    static constexpr double JOIN_STATS_REPORT_PERIOD_S{10};
+
+    /** The number of columns and rows of regions that the map is split into
+        for processing movement, AOI, and movement sync. Regions are
+        equal-sized rectangles, and each region after the first is processed
+        on its own worker thread.
+        Set both to 1 to process everything on the sim thread. */
+    static constexpr unsigned int SIM_REGION_COLUMNS{2};
+    static constexpr unsigned int SIM_REGION_ROWS{2};
+
+    //-------------------------------------------------------------------------
+    // Replication
+    //-------------------------------------------------------------------------
+    /** Entities within this distance of a client (in world units) have their
+        movement state synced on every tick that it changes. */
+    static constexpr float MOVEMENT_SYNC_NEAR_RADIUS{SharedConfig::AOI_RADIUS
+                                                     / 3};
+
+    /** Entities within this distance of a client (and outside of the near
+        radius) are synced at most once every MOVEMENT_SYNC_MID_INTERVAL
+        ticks. Entities past this radius are synced at most once every
+        MOVEMENT_SYNC_FAR_INTERVAL ticks. */
+    static constexpr float MOVEMENT_SYNC_MID_RADIUS{
+        (SharedConfig::AOI_RADIUS * 2) / 3};
+    static constexpr unsigned int MOVEMENT_SYNC_MID_INTERVAL{2};
+    static constexpr unsigned int MOVEMENT_SYNC_FAR_INTERVAL{4};
+
+    /** The max number of movement sync bytes that we'll queue for a single
+        client per network tick. When more entities need to be synced than
+        will fit, the most important ones are sent and the rest wait for a
+        later tick. */
+    static constexpr std::size_t MOVEMENT_SYNC_BYTES_PER_NETWORK_TICK{6'000};
+
+    /** The max number of chunk data bytes that we'll send per sim tick,
+        across all clients. When more chunks are requested than will fit,
+        the rest are sent on later ticks. */
+    static constexpr std::size_t CHUNK_STREAMING_BYTES_PER_TICK{48'000};
+
+    /** The max number of chunk data bytes that we'll send to a single client
+        per sim tick.
+        Note: Since the sim ticks faster than the network, a client's batch
+              may contain multiple ticks worth of chunks. If it exceeds
+              SharedConfig::MAX_BATCH_SIZE, it'll be split into multiple
+              batches. */
+    static constexpr std::size_t CHUNK_STREAMING_CLIENT_BYTES_PER_TICK{6'000};
+
+    /** The max number of chunks that we'll keep serialized messages cached
+        for. When full, the least recently requested chunk is evicted. */
+    static constexpr std::size_t CHUNK_CACHE_MAX_CHUNKS{4096};
+
     //-------------------------------------------------------------------------
     // Network
     //-------------------------------------------------------------------------
@@ -123,6 +191,11 @@ public:
     /** The minimum number of fresh diffs we'll use to calculate an adjustment.
         Aims to prevent thrashing. */
     static constexpr unsigned int MIN_FRESH_DIFFS{3};
+
+    /** If true, every event that the network passes to the simulation will
+        be recorded to a file, so the session can be replayed offline.
+        See SessionRecorder. */
+    static constexpr bool RECORD_SESSION{false};
 };
 
 } // End namespace Server
@@ -1,9 +1,11 @@
 #include "Application.h"
 #include "SharedConfig.h"
+#include "SleepTools.h"
 #include "Log.h"
 
 #include "Tracy.hpp"
 #include <functional>
+#include <algorithm>
 #include <string>
 #include <iostream>
 
@@ -24,8 +26,10 @@ Application::Application()
             SharedConfig::SIM_TICK_TIMESTEP_S, "Sim", false)
 , exitRequested(false)
 {
-    // Enable delay reporting.
+    // Enable delay and jitter reporting.
     simCaller.reportDelays(Simulation::SIM_DELAYED_TIME_S);
+    simCaller.reportJitter(JITTER_REPORT_PERIOD_S);
+    networkCaller.reportJitter(JITTER_REPORT_PERIOD_S);
 }
 
 void Application::start()
@@ -44,16 +48,10 @@ void Application::start()
         // Send any queued messages, if necessary.
         networkCaller.update();
 
-        // See if we have enough time left to sleep.
+        // Sleep until the next call is due.
         double simTimeLeft{simCaller.getTimeTillNextCall()};
         double networkTimeLeft{networkCaller.getTimeTillNextCall()};
-        if ((simTimeLeft > SLEEP_MINIMUM_TIME_S)
-            && (networkTimeLeft > SLEEP_MINIMUM_TIME_S)) {
-            // We have enough time to sleep for a few ms.
-            // Note: We try to delay for 1ms because the OS will generally end
-            //       up delaying us for 1-3ms.
-            SDL_Delay(1);
-        }
+        SleepTools::sleepFor(std::min(simTimeLeft, networkTimeLeft));
     }
 }
 
@@ -64,12 +64,9 @@ public:
     void registerSimulationExtension();
 
 private:
-    /** The minimum "time to next call" required to trigger a main loop sleep.
-        We sleep for 1ms when possible to reduce our CPU usage. We can't trust
-        the scheduler to come back to us after exactly 1ms though, so we busy
-        wait if something needs to be called soon.
-        Higher value == more CPU usage. */
-    static constexpr double SLEEP_MINIMUM_TIME_S = .003;
+    /** How often to log the sim and network tick start time jitter, in
+        seconds. */
+    static constexpr double JITTER_REPORT_PERIOD_S = 60;
 
     //-------------------------------------------------------------------------
     // SDL Objects
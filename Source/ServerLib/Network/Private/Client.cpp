@@ -9,6 +9,7 @@
 #include "Ignore.h"
 #include <cmath>
 #include <array>
+#include <algorithm>
 
 namespace AM
 {
@@ -18,10 +19,18 @@ BinaryBuffer Client::batchBuffer(SharedConfig::MAX_BATCH_SIZE);
 // No default size since it's dynamically enlarged if too small.
 BinaryBuffer Client::compressedBatchBuffer;
 
+// The batch size field only has 15 bits. Since we only send compressed
+// batches when they're smaller than the uncompressed data, this keeps every
+// batch representable.
+static_assert((SharedConfig::MAX_BATCH_SIZE - SERVER_HEADER_SIZE)
+                  < MAX_BATCH_SIZE,
+              "SharedConfig::MAX_BATCH_SIZE is too large for the header.");
+
 Client::Client(NetworkID inNetID, std::unique_ptr<Peer> inPeer)
 : netID{inNetID}
 , peer{std::move(inPeer)}
 , receiveTimer{}
+, isAdmitted{false}
 , latestSentSimTick{0}
 , tickDiffHistory{Config::TICKDIFF_TARGET}
 , numFreshDiffs{0}
@@ -49,8 +58,15 @@ NetworkResult Client::sendWaitingMessages(Uint32 currentTick)
         return NetworkResult::Success;
     }
 
-    // Copy any waiting messages into the buffer.
+    // Get the adjustment once, so every batch that we send in this call
+    // carries the same one.
+    AdjustmentData tickAdjustment{getTickAdjustment()};
+
+    // Copy any waiting messages into the buffer. If the batch fills up, send
+    // it and start a new one.
     std::size_t currentIndex{ServerHeaderIndex::MessageHeaderStart};
+    bool batchWasSent{false};
+    NetworkResult result{NetworkResult::Success};
     for (std::size_t i = 0; i < messageCount; ++i) {
         // Pop the message.
         QueuedMessage queuedMessage;
@@ -58,20 +74,32 @@ NetworkResult Client::sendWaitingMessages(Uint32 currentTick)
         AM_ASSERT(dequeueSucceeded, "Expected element but dequeue failed.");
         ignore(dequeueSucceeded);
 
-        // If the message would make the batch too large, error.
-        std::size_t messageSize{queuedMessage.message->size()};
-        AM_ASSERT(
-            ((currentIndex + messageSize) <= SharedConfig::MAX_BATCH_SIZE),
-            "Batch too large to fit into buffers. Increase MAX_BATCH_SIZE. "
-            "Size: %u, Max: %u",
-            (currentIndex + messageSize), SharedConfig::MAX_BATCH_SIZE);
-
-        // Copy the message data into the batchBuffer.
-        std::copy(queuedMessage.message->begin(), queuedMessage.message->end(),
-                  &(batchBuffer[currentIndex]));
+        // If the message can't fit in a batch on its own, split it up.
+        const BinaryBuffer& message{*(queuedMessage.message)};
+        std::size_t messageSize{message.size()};
+        if (messageSize > MAX_MESSAGE_SIZE_IN_BATCH) {
+            result = addFragmentedMessage(message, currentIndex,
+                                          tickAdjustment);
+            batchWasSent = true;
+        }
+        else {
+            // If the message would make the batch too large, send the batch
+            // and start a new one.
+            if ((currentIndex + messageSize) > SharedConfig::MAX_BATCH_SIZE) {
+                result = sendBatch(currentIndex, tickAdjustment);
+                currentIndex = ServerHeaderIndex::MessageHeaderStart;
+                batchWasSent = true;
+            }
+
+            // Copy the message data into the batchBuffer.
+            std::copy(message.begin(), message.end(),
+                      &(batchBuffer[currentIndex]));
+            currentIndex += messageSize;
+        }
 
-        // Increment the index.
-        currentIndex += messageSize;
+        if (result == NetworkResult::Disconnected) {
+            return result;
+        }
 
         // Track the latest tick we've sent.
         if (queuedMessage.tick != 0) {
@@ -82,30 +110,109 @@ NetworkResult Client::sendWaitingMessages(Uint32 currentTick)
     // If we've started talking to this client and none of this batch's
     // messages confirm the latest tick, add an explicit confirmation message.
     if ((latestSentSimTick != 0) && (latestSentSimTick < (currentTick - 1))) {
+        if ((currentIndex + EXPLICIT_CONFIRMATION_SIZE)
+            > SharedConfig::MAX_BATCH_SIZE) {
+            result = sendBatch(currentIndex, tickAdjustment);
+            currentIndex = ServerHeaderIndex::MessageHeaderStart;
+            batchWasSent = true;
+            if (result == NetworkResult::Disconnected) {
+                return result;
+            }
+        }
+
         addExplicitConfirmation(currentIndex, currentTick);
     }
 
-    // If the batch + header is too large, error.
-    AM_ASSERT((currentIndex <= SharedConfig::MAX_BATCH_SIZE),
-              "Batch too large to fit into buffers. Increase MAX_BATCH_SIZE. "
-              "Size: %u, Max: %u",
-              currentIndex, SharedConfig::MAX_BATCH_SIZE);
+    // Send the last batch.
+    // Note: If nothing else was sent, we send it even if it's empty, so the
+    //       client still gets its header.
+    if ((currentIndex > ServerHeaderIndex::MessageHeaderStart)
+        || !batchWasSent) {
+        result = sendBatch(currentIndex, tickAdjustment);
+    }
 
+    return result;
+}
+
+NetworkResult Client::addFragmentedMessage(const BinaryBuffer& message,
+                                           std::size_t& currentIndex,
+                                           const AdjustmentData& tickAdjustment)
+{
+    Uint8 messageType{message[MessageHeaderIndex::MessageType]};
+    const Uint8* payload{&(message[MessageHeaderIndex::MessageStart])};
+    std::size_t payloadSize{message.size() - MESSAGE_HEADER_SIZE};
+    if (payloadSize > SharedConfig::MAX_MESSAGE_SIZE) {
+        LOG_FATAL("Tried to send a too-large message. Size: %u, max: %u",
+                  payloadSize, SharedConfig::MAX_MESSAGE_SIZE);
+    }
+
+    // Fill batches with fragments until the whole payload has been added.
+    // Note: The last fragment is left in the batch, so later messages can
+    //       fill the rest of it.
+    std::size_t payloadIndex{0};
+    while (payloadIndex < payloadSize) {
+        // If there isn't room for any fragment bytes, send the batch.
+        if ((currentIndex + FRAGMENT_OVERHEAD)
+            >= SharedConfig::MAX_BATCH_SIZE) {
+            NetworkResult result{sendBatch(currentIndex, tickAdjustment)};
+            currentIndex = ServerHeaderIndex::MessageHeaderStart;
+            if (result == NetworkResult::Disconnected) {
+                return result;
+            }
+        }
+
+        // Fill the rest of the batch with as much of the payload as will fit.
+        std::size_t fragmentSize{std::min(
+            (payloadSize - payloadIndex),
+            (SharedConfig::MAX_BATCH_SIZE - currentIndex - FRAGMENT_OVERHEAD))};
+
+        // Write the message header.
+        Uint8* messageHeader{&(batchBuffer[currentIndex])};
+        messageHeader[MessageHeaderIndex::MessageType]
+            = static_cast<Uint8>(MessageType::MessageFragment);
+        ByteTools::write16(
+            static_cast<Uint16>(MESSAGE_FRAGMENT_HEADER_SIZE + fragmentSize),
+            &(messageHeader[MessageHeaderIndex::Size]));
+
+        // Write the fragment header.
+        Uint8* fragmentHeader{&(messageHeader[MESSAGE_HEADER_SIZE])};
+        fragmentHeader[MessageFragmentIndex::MessageType] = messageType;
+        ByteTools::write32(static_cast<Uint32>(payloadSize),
+                           &(fragmentHeader[MessageFragmentIndex::TotalSize]));
+
+        // Copy the fragment's bytes.
+        std::copy((payload + payloadIndex),
+                  (payload + payloadIndex + fragmentSize),
+                  &(fragmentHeader[MessageFragmentIndex::FragmentStart]));
+
+        currentIndex += (FRAGMENT_OVERHEAD + fragmentSize);
+        payloadIndex += fragmentSize;
+    }
+
+    return NetworkResult::Success;
+}
+
+NetworkResult Client::sendBatch(std::size_t currentIndex,
+                                const AdjustmentData& tickAdjustment)
+{
     // If we have a large enough payload, compress it.
     std::size_t batchSize{currentIndex - SERVER_HEADER_SIZE};
     Uint8* bufferToSend{&(batchBuffer[0])};
     bool isCompressed{false};
     if (batchSize > SharedConfig::BATCH_COMPRESSION_THRESHOLD) {
-        batchSize = compressBatch(batchSize);
-
-        isCompressed = true;
+        std::size_t compressedSize{compressBatch(batchSize)};
 
-        // Use the compressed buffer.
-        bufferToSend = &(compressedBatchBuffer[0]);
+        // If compression actually saved space, use the compressed buffer.
+        if (compressedSize < batchSize) {
+            batchSize = compressedSize;
+            isCompressed = true;
+            bufferToSend = &(compressedBatchBuffer[0]);
+        }
     }
 
     // Fill in the header.
-    fillHeader(bufferToSend, static_cast<Uint16>(batchSize), isCompressed);
+    fillHeader(bufferToSend, tickAdjustment, static_cast<Uint16>(batchSize),
+               isCompressed);
 
     // Record the number of sent bytes.
     std::size_t totalSize{SERVER_HEADER_SIZE + batchSize};
@@ -172,8 +279,8 @@ std::size_t Client::compressBatch(std::size_t batchSize)
 {
     // If the destination buffer is too small, resize it.
     std::size_t compressBound{ByteTools::compressBound(batchSize)};
-    if (compressedBatchBuffer.size() < compressBound) {
-        compressedBatchBuffer.resize(compressBound);
+    if (compressedBatchBuffer.size() < (SERVER_HEADER_SIZE + compressBound)) {
+        compressedBatchBuffer.resize(SERVER_HEADER_SIZE + compressBound);
     }
 
     // Compress the batch.
@@ -181,19 +288,16 @@ std::size_t Client::compressBatch(std::size_t batchSize)
         static_cast<std::size_t>(ByteTools::compress(
             &(batchBuffer[ServerHeaderIndex::MessageHeaderStart]), batchSize,
             &(compressedBatchBuffer[ServerHeaderIndex::MessageHeaderStart]),
-            compressedBatchBuffer.size()))};
-    AM_ASSERT((compressedBatchSize <= MAX_BATCH_SIZE),
-              "Batch too large, even after compression. Size: %u",
-              compressedBatchSize);
+            (compressedBatchBuffer.size() - SERVER_HEADER_SIZE)))};
 
     return compressedBatchSize;
 }
 
-void Client::fillHeader(Uint8* bufferToFill, Uint16 batchSize,
+void Client::fillHeader(Uint8* bufferToFill,
+                        const AdjustmentData& tickAdjustment, Uint16 batchSize,
                         bool isCompressed)
 {
     // Fill in the header adjustment info.
-    AdjustmentData tickAdjustment{getTickAdjustment()};
     bufferToFill[ServerHeaderIndex::TickAdjustment]
         = static_cast<Uint8>(tickAdjustment.adjustment);
     bufferToFill[ServerHeaderIndex::AdjustmentIteration]
@@ -261,6 +365,13 @@ ReceiveResult Client::receiveMessage(Uint8* messageBuffer)
         }
     }
     else if (headerResult == NetworkResult::NoWaitingData) {
+        // If we haven't been admitted into the sim yet, we aren't expected to
+        // be sending anything. Hold the timer at 0.
+        if (!isAdmitted) {
+            receiveTimer.reset();
+            return {NetworkResult::NoWaitingData};
+        }
+
         // If we timed out, drop the connection.
         double delta{receiveTimer.getTime()};
         if (delta > Config::CLIENT_TIMEOUT_S) {
@@ -328,6 +439,11 @@ NetworkID Client::getNetID()
     return netID;
 }
 
+void Client::setAdmitted()
+{
+    isAdmitted = true;
+}
+
 Sint8 Client::calcAdjustment(
     CircularBuffer<Sint8, Config::TICKDIFF_HISTORY_LENGTH>& tickDiffHistoryCopy,
     unsigned int numFreshDiffsCopy)
@@ -24,6 +24,7 @@ ClientHandler::ClientHandler(Network& inNetwork, EventDispatcher& inDispatcher,
 , clientSet{std::make_shared<SocketSet>(Config::MAX_CLIENTS)}
 , acceptor{Config::SERVER_PORT, clientSet}
 , messageRecBuffer(Peer::MAX_WIRE_SIZE)
+, sessionRecorder{}
 , receiveThreadObj{}
 , exitRequested{false}
 , sendRequested{false}
@@ -135,6 +136,9 @@ void ClientHandler::acceptNewClients(ClientMap& clientMap)
         NetworkID newID{idPool.reserveID()};
         LOG_INFO("New client connected. Assigning netID: %u", newID);
 
+        // Clear any inputs left over from the ID's previous owner.
+        network.getClientInputRings().resetClient(newID);
+
         {
             // Add the peer to the Network's clientMap.
             std::unique_lock writeLock{network.getClientMapMutex()};
@@ -151,6 +155,7 @@ void ClientHandler::acceptNewClients(ClientMap& clientMap)
         clientCount++;
 
         // Notify the sim that a client was connected.
+        sessionRecorder.recordClientConnected(network.getCurrentTick(), newID);
         dispatcher.emplace<ClientConnected>(newID);
 
         newPeer = acceptor.accept();
@@ -182,6 +187,8 @@ void ClientHandler::eraseDisconnectedClients(ClientMap& clientMap)
 
             // Notify the sim that a client was disconnected.
             LOG_INFO("Erased disconnected client with netID: %u.", clientID);
+            sessionRecorder.recordClientDisconnected(network.getCurrentTick(),
+                                                     clientID);
             dispatcher.emplace<ClientDisconnected>(clientID);
         }
         else {
@@ -230,6 +237,13 @@ void ClientHandler::processReceivedMessage(Client& client,
                                            MessageType messageType,
                                            unsigned int messageSize)
 {
+    // If the message is going to be passed to the sim, record it.
+    if (messageType != MessageType::Heartbeat) {
+        sessionRecorder.recordMessage(network.getCurrentTick(),
+                                      client.getNetID(), messageType,
+                                      messageRecBuffer.data(), messageSize);
+    }
+
     // Process the message.
     // Note: messageTick will be > -1 if the message contained a tick number.
     Sint64 messageTick{messageProcessor.processReceivedMessage(
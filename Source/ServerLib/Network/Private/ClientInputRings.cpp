@@ -0,0 +1,144 @@
+#include "ClientInputRings.h"
+#include "NetworkStats.h"
+#include "Log.h"
+
+namespace AM
+{
+namespace Server
+{
+ClientInputRings::ClientInputRings(std::size_t inClientCapacity)
+: rings(inClientCapacity)
+, currentTickPtr{nullptr}
+{
+}
+
+void ClientInputRings::registerCurrentTickPtr(
+    const std::atomic<Uint32>* inCurrentTickPtr)
+{
+    currentTickPtr = inCurrentTickPtr;
+}
+
+void ClientInputRings::resetClient(NetworkID netID)
+{
+    if (netID >= rings.size()) {
+        LOG_FATAL("NetworkID out of range: %u", netID);
+    }
+
+    Ring& ring{rings[netID]};
+    for (std::atomic<Uint64>& slot : ring.slots) {
+        slot.store(0, std::memory_order_relaxed);
+    }
+    ring.inputDropped.store(false, std::memory_order_release);
+}
+
+bool ClientInputRings::push(NetworkID netID, Uint32 tickNum,
+                            const Input& input)
+{
+    if (netID >= rings.size()) {
+        LOG_FATAL("NetworkID out of range: %u", netID);
+    }
+    Ring& ring{rings[netID]};
+
+    // If the tick is outside of our buffer, drop the input.
+    Uint32 currentTick{*currentTickPtr};
+    if ((tickNum < currentTick) || (tickNum >= (currentTick + RING_SIZE))) {
+        LOG_INFO_RATE_LIMITED(
+            "Dropped message from %u. Tick: %u, received: %u", netID,
+            currentTick, tickNum);
+        ring.inputDropped.store(true, std::memory_order_release);
+        return false;
+    }
+
+    // Replace whatever is in the tick's slot. If the client already sent an
+    // input for this tick, the latest one wins.
+    // Note: Any older tick that's still in the slot has already been
+    //       processed, since it's at least RING_SIZE ticks behind this one.
+    std::atomic<Uint64>& slot{ring.slots[tickNum % RING_SIZE]};
+    Uint64 newValue{packSlot(tickNum, input.inputStates, HAS_INPUT_FLAG)};
+    Uint64 oldValue{slot.load(std::memory_order_acquire)};
+    do {
+        // If the sim already processed this tick, we're too late.
+        if ((getSlotTick(oldValue) == tickNum)
+            && (oldValue & CONSUMED_FLAG)) {
+            LOG_INFO_RATE_LIMITED(
+                "Dropped message from %u. Tick: %u, received: %u", netID,
+                currentTick, tickNum);
+            ring.inputDropped.store(true, std::memory_order_release);
+            return false;
+        }
+    } while (!(slot.compare_exchange_weak(oldValue, newValue,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire)));
+
+    // If we replaced an input for the same tick, count it as coalesced.
+    if ((getSlotTick(oldValue) == tickNum) && (oldValue & HAS_INPUT_FLAG)) {
+        NetworkStats::recordInputsCoalesced(1);
+    }
+
+    return true;
+}
+
+bool ClientInputRings::pop(NetworkID netID, Uint32 tickNum, Input& input)
+{
+    if (netID >= rings.size()) {
+        LOG_FATAL("NetworkID out of range: %u", netID);
+    }
+
+    // Mark the tick as processed, and get whatever was in its slot.
+    std::atomic<Uint64>& slot{rings[netID].slots[tickNum % RING_SIZE]};
+    Uint64 slotValue{slot.exchange(packSlot(tickNum, {}, CONSUMED_FLAG),
+                                   std::memory_order_acq_rel)};
+
+    // If the slot doesn't hold an input for this tick, there's nothing to
+    // pop.
+    if ((getSlotTick(slotValue) != tickNum)
+        || !(slotValue & HAS_INPUT_FLAG)) {
+        return false;
+    }
+
+    // Unpack the input states.
+    for (std::size_t i = 0; i < input.inputStates.size(); ++i) {
+        Uint64 stateBit{Uint64{1} << (INPUT_STATES_SHIFT + i)};
+        input.inputStates[i]
+            = (slotValue & stateBit) ? Input::Pressed : Input::Released;
+    }
+
+    return true;
+}
+
+bool ClientInputRings::takeDropped(NetworkID netID)
+{
+    if (netID >= rings.size()) {
+        LOG_FATAL("NetworkID out of range: %u", netID);
+    }
+
+    // Note: We check before exchanging, since this is called for every
+    //       client every tick and drops are rare.
+    std::atomic<bool>& inputDropped{rings[netID].inputDropped};
+    if (!(inputDropped.load(std::memory_order_acquire))) {
+        return false;
+    }
+    return inputDropped.exchange(false, std::memory_order_acq_rel);
+}
+
+Uint64 ClientInputRings::packSlot(Uint32 tickNum,
+                                  const Input::StateArr& inputStates,
+                                  Uint64 flags)
+{
+    Uint64 slotValue{tickNum | flags};
+    for (std::size_t i = 0; i < inputStates.size(); ++i) {
+        if (inputStates[i] == Input::Pressed) {
+            slotValue |= (Uint64{1} << (INPUT_STATES_SHIFT + i));
+        }
+    }
+
+    return slotValue;
+}
+
+Uint32 ClientInputRings::getSlotTick(Uint64 slotValue)
+{
+    return static_cast<Uint32>(slotValue & 0xFFFFFFFF);
+}
+
+} // End namespace Server
+} // End namespace AM
@@ -3,6 +3,7 @@
 #include "Deserialize.h"
 #include "DispatchMessage.h"
 #include "IMessageProcessorExtension.h"
+#include "ClientInputRings.h"
 #include "ServerNetworkDefs.h"
 #include "Heartbeat.h"
 #include "InputChangeRequest.h"
@@ -14,8 +15,10 @@ namespace AM
 {
 namespace Server
 {
-MessageProcessor::MessageProcessor(EventDispatcher& inNetworkEventDispatcher)
+MessageProcessor::MessageProcessor(EventDispatcher& inNetworkEventDispatcher,
+                                   ClientInputRings& inClientInputRings)
 : networkEventDispatcher{inNetworkEventDispatcher}
+, clientInputRings{inClientInputRings}
 {
 }
 
@@ -82,11 +85,11 @@ Uint32 MessageProcessor::handleInputChangeRequest(NetworkID netID,
     InputChangeRequest inputChangeRequest{};
     Deserialize::fromBuffer(messageBuffer, messageSize, inputChangeRequest);
 
-    // Fill in the network ID that we assigned to this client.
-    inputChangeRequest.netID = netID;
-
-    // Push the message into any subscribed queues.
-    networkEventDispatcher.push<InputChangeRequest>(inputChangeRequest);
+    // Push the input into the client's ring.
+    // Note: If the tick is out of range, the input is dropped and the sim
+    //       is notified through the ring.
+    clientInputRings.push(netID, inputChangeRequest.tickNum,
+                          inputChangeRequest.input);
 
     // Return the tick number associated with this message.
     return inputChangeRequest.tickNum;
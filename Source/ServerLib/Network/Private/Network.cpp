@@ -6,6 +6,8 @@
 #include "Log.h"
 #include "NetworkStats.h"
 #include "IMessageProcessorExtension.h"
+#include "IDPool.h"
+#include "Config.h"
 #include <SDL_net.h>
 #include "Tracy.hpp"
 #include <algorithm>
@@ -17,8 +19,10 @@ namespace Server
 {
 
 Network::Network()
-: eventDispatcher{}
-, messageProcessor{eventDispatcher}
+: clientMap{Config::MAX_CLIENTS + IDPool::SAFETY_BUFFER}
+, eventDispatcher{}
+, clientInputRings{Config::MAX_CLIENTS + IDPool::SAFETY_BUFFER}
+, messageProcessor{eventDispatcher, clientInputRings}
 , clientHandler{*this, eventDispatcher, messageProcessor}
 , ticksSinceNetstatsLog{0}
 , currentTickPtr{nullptr}
@@ -46,6 +50,11 @@ EventDispatcher& Network::getEventDispatcher()
     return eventDispatcher;
 }
 
+ClientInputRings& Network::getClientInputRings()
+{
+    return clientInputRings;
+}
+
 ClientMap& Network::getClientMap()
 {
     return clientMap;
@@ -60,6 +69,7 @@ void Network::registerCurrentTickPtr(
     const std::atomic<Uint32>* inCurrentTickPtr)
 {
     currentTickPtr = inCurrentTickPtr;
+    clientInputRings.registerCurrentTickPtr(inCurrentTickPtr);
 }
 
 Uint32 Network::getCurrentTick()
@@ -86,6 +96,18 @@ void Network::send(NetworkID networkID, const BinaryBufferSharedPtr& message,
     }
 }
 
+void Network::setClientAdmitted(NetworkID networkID)
+{
+    // Acquire a read lock before running through the client map.
+    std::shared_lock readLock(clientMapMutex);
+
+    // If the client still exists, mark it as admitted.
+    auto clientPair = clientMap.find(networkID);
+    if (clientPair != clientMap.end()) {
+        clientPair->second->setAdmitted();
+    }
+}
+
 void Network::logNetworkStatistics()
 {
     // Dump the stats from the tracker.
@@ -96,8 +118,12 @@ void Network::logNetworkStatistics()
                              / static_cast<float>(SECONDS_TILL_STATS_DUMP)};
     float bytesReceivedPerSecond{netStats.bytesReceived
                                  / static_cast<float>(SECONDS_TILL_STATS_DUMP)};
-    LOG_INFO("Bytes sent per second: %.0f, Bytes received per second: %.0f",
-             bytesSentPerSecond, bytesReceivedPerSecond);
+    float inputsCoalescedPerSecond{
+        netStats.inputsCoalesced / static_cast<float>(SECONDS_TILL_STATS_DUMP)};
+    LOG_INFO("Bytes sent per second: %.0f, Bytes received per second: %.0f, "
+             "Inputs coalesced per second: %.1f",
+             bytesSentPerSecond, bytesReceivedPerSecond,
+             inputsCoalescedPerSecond);
 }
 
 } // namespace Server
@@ -0,0 +1,88 @@
+#include "SessionRecorder.h"
+#include "Config.h"
+#include "ByteTools.h"
+#include "Log.h"
+#include <array>
+
+namespace AM
+{
+namespace Server
+{
+SessionRecorder::SessionRecorder()
+: recordingFile{}
+{
+    if (!Config::RECORD_SESSION) {
+        return;
+    }
+
+    recordingFile.open(FILE_NAME, std::ios::binary | std::ios::trunc);
+    if (!(recordingFile.is_open())) {
+        LOG_ERROR("Failed to open session recording file: %s", FILE_NAME);
+        return;
+    }
+
+    std::array<Uint8, FILE_HEADER_SIZE> fileHeader{};
+    ByteTools::write16(FORMAT_VERSION, fileHeader.data());
+    recordingFile.write(reinterpret_cast<const char*>(fileHeader.data()),
+                        fileHeader.size());
+
+    LOG_INFO("Recording session to %s", FILE_NAME);
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    if (recordingFile.is_open()) {
+        recordingFile.flush();
+    }
+}
+
+void SessionRecorder::recordMessage(Uint32 tick, NetworkID netID,
+                                    MessageType messageType,
+                                    const Uint8* messageBuffer,
+                                    unsigned int messageSize)
+{
+    writeRecord(tick, RecordType::Message, netID, messageType, messageBuffer,
+                static_cast<Uint16>(messageSize));
+}
+
+void SessionRecorder::recordClientConnected(Uint32 tick, NetworkID netID)
+{
+    writeRecord(tick, RecordType::ClientConnected, netID,
+                MessageType::NotSet, nullptr, 0);
+}
+
+void SessionRecorder::recordClientDisconnected(Uint32 tick, NetworkID netID)
+{
+    writeRecord(tick, RecordType::ClientDisconnected, netID,
+                MessageType::NotSet, nullptr, 0);
+}
+
+void SessionRecorder::writeRecord(Uint32 tick, RecordType recordType,
+                                  NetworkID netID, MessageType messageType,
+                                  const Uint8* messageBuffer,
+                                  Uint16 messageSize)
+{
+    // If recording isn't enabled, do nothing.
+    if (!(recordingFile.is_open())) {
+        return;
+    }
+
+    // Write the record header.
+    std::array<Uint8, RECORD_HEADER_SIZE> recordHeader{};
+    ByteTools::write32(tick, &(recordHeader[0]));
+    recordHeader[4] = static_cast<Uint8>(recordType);
+    ByteTools::write32(netID, &(recordHeader[5]));
+    recordHeader[9] = static_cast<Uint8>(messageType);
+    ByteTools::write16(messageSize, &(recordHeader[10]));
+    recordingFile.write(reinterpret_cast<const char*>(recordHeader.data()),
+                        recordHeader.size());
+
+    // Write the message, if there is one.
+    if (messageSize > 0) {
+        recordingFile.write(reinterpret_cast<const char*>(messageBuffer),
+                            messageSize);
+    }
+}
+
+} // End namespace Server
+} // End namespace AM
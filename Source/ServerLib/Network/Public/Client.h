@@ -38,6 +38,10 @@ public:
     /**
      * Attempts to send all queued messages over the network.
      *
+     * If the messages don't fit in a single batch, multiple batches are
+     * sent. Messages that are too large for a batch on their own are split
+     * into MessageFragments, for the client to reassemble.
+     *
      * @param currentTick  The sim's current tick.
      * @return An appropriate NetworkResult.
      */
@@ -82,7 +86,37 @@ public:
 
     NetworkID getNetID();
 
+    /**
+     * Marks this client as admitted into the sim, starting its receive
+     * timeout.
+     *
+     * Until this is called, the client is waiting to be spawned (see
+     * ClientConnectionSystem's join queue) and isn't expected to send us
+     * anything, so it can't time out.
+     */
+    void setAdmitted();
+
 private:
+    struct AdjustmentData {
+        /** The amount of adjustment. */
+        Sint8 adjustment;
+        /** The adjustment iteration that we're on. */
+        Uint8 iteration;
+    };
+
+    /** The largest message that we'll add to a batch as-is. Anything larger
+        is split into MessageFragments. */
+    static constexpr std::size_t MAX_MESSAGE_SIZE_IN_BATCH{
+        SharedConfig::MAX_BATCH_SIZE - SERVER_HEADER_SIZE};
+
+    /** The number of bytes that each fragment adds on top of its data. */
+    static constexpr std::size_t FRAGMENT_OVERHEAD{
+        MESSAGE_HEADER_SIZE + MESSAGE_FRAGMENT_HEADER_SIZE};
+
+    /** The size of an ExplicitConfirmation message, including its header. */
+    static constexpr std::size_t EXPLICIT_CONFIRMATION_SIZE{
+        MESSAGE_HEADER_SIZE + 1};
+
     //--------------------------------------------------------------------------
     // Helpers
     //--------------------------------------------------------------------------
@@ -96,6 +130,28 @@ private:
      */
     void addExplicitConfirmation(std::size_t& currentIndex, Uint32 currentTick);
 
+    /**
+     * Splits the given message into MessageFragments and adds them to
+     * batchBuffer, sending the batch each time it fills up.
+     *
+     * @param message  The message to add. Must contain a message header.
+     * @param currentIndex  The current end of the batch. Will be updated to
+     *                      point past the last added fragment.
+     * @return Disconnected if a send failed, else Success.
+     */
+    NetworkResult addFragmentedMessage(const BinaryBuffer& message,
+                                       std::size_t& currentIndex,
+                                       const AdjustmentData& tickAdjustment);
+
+    /**
+     * Compresses the batch in batchBuffer if necessary, fills in its header,
+     * and sends it.
+     *
+     * @param currentIndex  The current end of the batch.
+     */
+    NetworkResult sendBatch(std::size_t currentIndex,
+                            const AdjustmentData& tickAdjustment);
+
     /**
      * Compresses the first batchSize bytes in the payload section of
      * batchBuffer into compressedBatchBuffer and returns the compressed
@@ -108,10 +164,12 @@ private:
      * built.
      *
      * @param bufferToFill  The buffer that should have its header filled.
+     * @param tickAdjustment  The adjustment to send.
      * @param batchSize  The size, in bytes, of the current batch.
      * @param isCompressed  True if the batch is compressed, else false.
      */
-    void fillHeader(Uint8* bufferToFill, Uint16 batchSize, bool isCompressed);
+    void fillHeader(Uint8* bufferToFill, const AdjustmentData& tickAdjustment,
+                    Uint16 batchSize, bool isCompressed);
 
     //--------------------------------------------------------------------------
     // Connection, Batching
@@ -148,16 +206,13 @@ private:
         client. */
     Timer receiveTimer;
 
+    /** If true, this client has been spawned into the sim and can time out.
+        Set by the sim thread, read by the receive thread. */
+    std::atomic<bool> isAdmitted;
+
     //--------------------------------------------------------------------------
     // Synchronization Functions
     //--------------------------------------------------------------------------
-    struct AdjustmentData {
-        /** The amount of adjustment. */
-        Sint8 adjustment;
-        /** The adjustment iteration that we're on. */
-        Uint8 iteration;
-    };
-
     /**
      * Calculates an appropriate tick adjustment for this client to make.
      * Increments adjustmentIteration every time it's called.
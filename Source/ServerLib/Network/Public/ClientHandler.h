@@ -5,6 +5,7 @@
 #include "Client.h"
 #include "Acceptor.h"
 #include "IDPool.h"
+#include "SessionRecorder.h"
 #include "Tracy.hpp"
 #include <thread>
 #include <queue>
@@ -128,6 +129,9 @@ private:
     /** Holds a received message while we pass it to MessageProcessor. */
     BinaryBuffer messageRecBuffer;
 
+    /** If enabled, records the events that we pass to the simulation. */
+    SessionRecorder sessionRecorder;
+
     /** Calls serviceClients(). */
     std::thread receiveThreadObj;
     /** Turn false to signal that the send and receive threads should end. */
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "NetworkDefs.h"
+#include "Input.h"
+#include <SDL_stdinc.h>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * Holds each client's upcoming inputs, indexed by the tick that they apply
+ * to.
+ *
+ * The receive thread pushes inputs as they arrive (see MessageProcessor),
+ * and InputSystem pops each client's input for the current tick. Each client
+ * has a fixed ring of slots indexed by (tick % RING_SIZE), and each slot is a
+ * single atomic word holding the tick, the input states, and some flags. This
+ * lets both sides run without locking, allocating, or hashing.
+ *
+ * Inputs for ticks outside of [currentTick, currentTick + RING_SIZE), or for
+ * a tick that the sim has already processed, are dropped. Drops are flagged
+ * so that the sim can react to them (see InputSystem::handleDroppedMessage()).
+ *
+ * Note: push() and resetClient() must only be called from a single thread
+ *       (the receive thread). pop() and takeDropped() must only be called
+ *       from a single thread (the sim thread).
+ */
+class ClientInputRings
+{
+public:
+    /** How many ticks into the future we'll buffer inputs for. If 10, the
+        valid range is [currentTick, currentTick + 10). */
+    static constexpr Uint32 RING_SIZE{10};
+
+    /**
+     * @param inClientCapacity  The number of clients to allocate rings for.
+     *                          Must be greater than the highest NetworkID
+     *                          that will be used.
+     */
+    ClientInputRings(std::size_t inClientCapacity);
+
+    /** Used for passing us a pointer to the sim's currentTick. */
+    void registerCurrentTickPtr(const std::atomic<Uint32>* inCurrentTickPtr);
+
+    /**
+     * Clears the given client's ring. Call when a new client is assigned the
+     * given ID, so it doesn't receive any of the previous client's state.
+     */
+    void resetClient(NetworkID netID);
+
+    /**
+     * Buffers the given input, to be applied on the given tick.
+     * If the client already has an input buffered for that tick, it's
+     * replaced (last writer wins) and counted as coalesced in NetworkStats.
+     * This way, a client that sends many changes in a single tick only costs
+     * the sim one input.
+     *
+     * @return true if the input was buffered, false if it was dropped.
+     */
+    bool push(NetworkID netID, Uint32 tickNum, const Input& input);
+
+    /**
+     * If the given client has an input buffered for the given tick, copies
+     * it into the given input.
+     *
+     * Marks the tick as processed, so any inputs that arrive for it later
+     * are dropped.
+     *
+     * @return true if an input was popped, else false.
+     */
+    bool pop(NetworkID netID, Uint32 tickNum, Input& input);
+
+    /**
+     * Returns true if any of the given client's inputs have been dropped
+     * since the last call.
+     */
+    bool takeDropped(NetworkID netID);
+
+private:
+    /** Slot layout: Bits 0-31 hold the tick, bits 32-37 hold the input
+        states, and the bits below hold flags. */
+    static constexpr Uint64 INPUT_STATES_SHIFT{32};
+    static constexpr Uint64 HAS_INPUT_FLAG{Uint64{1} << 40};
+    static constexpr Uint64 CONSUMED_FLAG{Uint64{1} << 41};
+
+    /**
+     * A single client's input ring.
+     * Aligned to avoid false sharing between clients.
+     */
+    struct alignas(64) Ring {
+        std::array<std::atomic<Uint64>, RING_SIZE> slots{};
+
+        /** If true, one of this client's inputs was dropped. */
+        std::atomic<bool> inputDropped{false};
+    };
+
+    /**
+     * Packs the given tick, input states, and flags into a slot value.
+     */
+    static Uint64 packSlot(Uint32 tickNum, const Input::StateArr& inputStates,
+                           Uint64 flags);
+
+    /**
+     * Returns the tick held in the given slot value.
+     */
+    static Uint32 getSlotTick(Uint64 slotValue);
+
+    /** Each client's input ring, indexed by NetworkID. */
+    std::vector<Ring> rings;
+
+    /** Pointer to the sim's current tick. */
+    const std::atomic<Uint32>* currentTickPtr;
+};
+
+} // End namespace Server
+} // End namespace AM
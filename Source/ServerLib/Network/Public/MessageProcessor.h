@@ -10,6 +10,7 @@ class EventDispatcher;
 
 namespace Server
 {
+class ClientInputRings;
 class IMessageProcessorExtension;
 
 /**
@@ -24,7 +25,8 @@ class IMessageProcessorExtension;
 class MessageProcessor
 {
 public:
-    MessageProcessor(EventDispatcher& inNetworkEventDispatcher);
+    MessageProcessor(EventDispatcher& inNetworkEventDispatcher,
+                     ClientInputRings& inClientInputRings);
 
     /**
      * Deserializes and handles received messages.
@@ -60,7 +62,7 @@ private:
     Uint32 handleHeartbeat(Uint8* messageBuffer, unsigned int messageSize);
 
     /**
-     * Pushes InputChangeRequest event.
+     * Pushes the requested input into the client's input ring.
      * @return The tick number that the message contained.
      */
     Uint32 handleInputChangeRequest(NetworkID netID, Uint8* messageBuffer,
@@ -75,6 +77,9 @@ private:
         queues. */
     EventDispatcher& networkEventDispatcher;
 
+    /** Used to pass client inputs directly to the simulation. */
+    ClientInputRings& clientInputRings;
+
     /** If non-nullptr, contains the project's message processing extension
         functions.
         Allows the project to provide message processing code and have it be
@@ -4,6 +4,7 @@
 #include "NetworkDefs.h"
 #include "ServerNetworkDefs.h"
 #include "MessageProcessor.h"
+#include "ClientInputRings.h"
 #include "ClientHandler.h"
 #include "Serialize.h"
 #include "Peer.h"
@@ -54,12 +55,50 @@ public:
     void serializeAndSend(NetworkID networkID, const T& messageStruct,
                           Uint32 messageTick = 0);
 
+    /**
+     * Serializes the given message into a buffer, with a message header.
+     *
+     * Used when sending the same message to multiple clients, so that it
+     * only needs to be serialized once. Pass the returned buffer to send().
+     *
+     * Note: This doesn't touch any of the Network's state, so it's safe to
+     *       call from any thread.
+     *
+     * @param messageStruct  A structure that defines MESSAGE_TYPE and has an
+     *                       associated serialize() function.
+     */
+    template<typename T>
+    BinaryBufferSharedPtr serialize(const T& messageStruct);
+
+    /**
+     * Queues a message to be sent the next time sendWaitingMessages is called.
+     * @throws std::out_of_range if id is not in the clients map.
+     *
+     * @param networkID  The client to send the message to.
+     * @param message  The message to send. Must contain a message header.
+     * @param messageTick  Optional, used when sending entity movement updates
+     *                     to update the Client's latestSentSimTick.
+     */
+    void send(NetworkID networkID, const BinaryBufferSharedPtr& message,
+              Uint32 messageTick = 0);
+
     /**
      * Returns the Network event dispatcher. All messages that we receive
      * from the server are pushed into this dispatcher.
      */
     EventDispatcher& getEventDispatcher();
 
+    /**
+     * Returns the rings that received client inputs are pushed into.
+     */
+    ClientInputRings& getClientInputRings();
+
+    /**
+     * Marks the given client as admitted into the sim. See
+     * Client::setAdmitted().
+     */
+    void setClientAdmitted(NetworkID networkID);
+
     /** Initialize the tick timer. */
     void initTimer();
 
@@ -87,18 +126,6 @@ public:
         std::unique_ptr<IMessageProcessorExtension> extension);
 
 private:
-    /**
-     * Queues a message to be sent the next time sendWaitingMessages is called.
-     * @throws std::out_of_range if id is not in the clients map.
-     *
-     * @param networkID  The client to send the message to.
-     * @param message  The message to send.
-     * @param messageTick  Optional, used when sending entity movement updates
-     *                     to update the Client's latestSentSimTick.
-     */
-    void send(NetworkID networkID, const BinaryBufferSharedPtr& message,
-              Uint32 messageTick = 0);
-
     /**
      * Logs the network stats such as bytes sent/received per second.
      */
@@ -114,6 +141,9 @@ private:
     /** Used to dispatch events from the network to the simulation. */
     EventDispatcher eventDispatcher;
 
+    /** Used to pass client inputs directly to the simulation. */
+    ClientInputRings clientInputRings;
+
     /** Deserializes messages, does any network-layer message handling, and
         passes messages down to the simulation. */
     MessageProcessor messageProcessor;
@@ -138,6 +168,13 @@ private:
 template<typename T>
 void Network::serializeAndSend(NetworkID networkID, const T& messageStruct,
                                Uint32 messageTick)
+{
+    // Serialize the message and send it.
+    send(networkID, serialize(messageStruct), messageTick);
+}
+
+template<typename T>
+BinaryBufferSharedPtr Network::serialize(const T& messageStruct)
 {
     // Allocate the buffer.
     std::size_t totalMessageSize{MESSAGE_HEADER_SIZE
@@ -160,8 +197,7 @@ void Network::serializeAndSend(NetworkID networkID, const T& messageStruct,
     ByteTools::write16(static_cast<Uint16>(messageSize),
                        (messageBuffer->data() + MessageHeaderIndex::Size));
 
-    // Send the message.
-    send(networkID, messageBuffer, messageTick);
+    return messageBuffer;
 }
 
 } // namespace Server
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "NetworkDefs.h"
-#include <unordered_map>
+#include "SlotMap.h"
 #include <memory>
 
 /**
@@ -14,9 +14,10 @@ namespace Server
 //--------------------------------------------------------------------------
 // Typedefs
 //--------------------------------------------------------------------------
-/** A map type used to manage clients. */
+/** A map type used to manage clients. Indexed directly by NetworkID, since
+    IDs are small and densely allocated by IDPool. */
 class Client;
-typedef std::unordered_map<NetworkID, std::shared_ptr<Client>> ClientMap;
+typedef SlotMap<std::shared_ptr<Client>> ClientMap;
 
 //--------------------------------------------------------------------------
 // Structs
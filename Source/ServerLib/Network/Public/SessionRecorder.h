@@ -0,0 +1,96 @@
+#pragma once
+
+#include "NetworkDefs.h"
+#include <SDL_stdinc.h>
+#include <fstream>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * Records everything that the network layer passes to the simulation, so
+ * that a session can be replayed offline (see the SessionReplay test
+ * sandbox).
+ *
+ * Only enabled if Config::RECORD_SESSION is true.
+ *
+ * File format:
+ *   Uint16 FORMAT_VERSION
+ *   Records, each:
+ *     Uint32 tick         The sim tick that the event was received on.
+ *     Uint8 recordType    A RecordType.
+ *     Uint32 netID        The client that the event relates to.
+ *     Uint8 messageType   If a Message record, the MessageType. Else 0.
+ *     Uint16 messageSize  If a Message record, the size of the message.
+ *                         Else 0.
+ *     [messageSize bytes] The serialized message, without a message header.
+ *
+ * Heartbeats are handled entirely in the network layer, so they aren't
+ * recorded.
+ *
+ * Note: All record functions must be called from the same thread.
+ */
+class SessionRecorder
+{
+public:
+    /** The version of the file format. Bump this when the format changes. */
+    static constexpr Uint16 FORMAT_VERSION{0};
+
+    /** The name of the file that sessions are recorded to. */
+    static constexpr const char* FILE_NAME{"SessionRecording.bin"};
+
+    /** The size of the file header, in bytes. */
+    static constexpr std::size_t FILE_HEADER_SIZE{2};
+
+    /** The size of each record's header, in bytes. */
+    static constexpr std::size_t RECORD_HEADER_SIZE{12};
+
+    /** The types of events that can be recorded. */
+    enum class RecordType : Uint8 {
+        Message,
+        ClientConnected,
+        ClientDisconnected
+    };
+
+    SessionRecorder();
+
+    ~SessionRecorder();
+
+    /**
+     * Records a received message that will be passed to the simulation.
+     *
+     * @param tick  The current sim tick.
+     * @param netID  The client that the message came from.
+     * @param messageType  The type of the message.
+     * @param messageBuffer  The serialized message, starting at index 0.
+     * @param messageSize  The length in bytes of the message.
+     */
+    void recordMessage(Uint32 tick, NetworkID netID, MessageType messageType,
+                       const Uint8* messageBuffer, unsigned int messageSize);
+
+    /**
+     * Records a client connecting.
+     */
+    void recordClientConnected(Uint32 tick, NetworkID netID);
+
+    /**
+     * Records a client disconnecting.
+     */
+    void recordClientDisconnected(Uint32 tick, NetworkID netID);
+
+private:
+    /**
+     * Writes a record to the file.
+     */
+    void writeRecord(Uint32 tick, RecordType recordType, NetworkID netID,
+                     MessageType messageType, const Uint8* messageBuffer,
+                     Uint16 messageSize);
+
+    /** The recording file. Only open if recording is enabled. */
+    std::ofstream recordingFile;
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,95 @@
+#include "ChunkEncoder.h"
+#include "Network.h"
+#include "ChunkUpdate.h"
+#include "SharedConfig.h"
+#include "Tracy.hpp"
+
+namespace AM
+{
+namespace Server
+{
+ChunkEncoder::ChunkEncoder(Network& inNetwork)
+: network{inNetwork}
+, jobQueue{}
+, resultQueue{}
+, paletteIndices{}
+, encodeThreadObj{}
+, exitRequested{false}
+{
+    // Start the encode thread.
+    encodeThreadObj = std::thread(&ChunkEncoder::encodeChunks, this);
+}
+
+ChunkEncoder::~ChunkEncoder()
+{
+    exitRequested = true;
+    encodeThreadObj.join();
+}
+
+void ChunkEncoder::pushJob(EncodeJob&& encodeJob)
+{
+    jobQueue.enqueue(std::move(encodeJob));
+}
+
+bool ChunkEncoder::popResult(EncodedChunk& encodedChunk)
+{
+    return resultQueue.try_dequeue(encodedChunk);
+}
+
+void ChunkEncoder::encodeChunks()
+{
+    tracy::SetThreadName("ChunkEncoder");
+
+    EncodeJob encodeJob{};
+    while (!exitRequested) {
+        // Wait for a job.
+        if (!(jobQueue.wait_dequeue_timed(encodeJob, JOB_WAIT_TIMEOUT_US))) {
+            continue;
+        }
+
+        ZoneScoped;
+
+        // Build the message and serialize it.
+        ChunkUpdate chunkUpdate{};
+        addChunkToMessage(encodeJob, chunkUpdate);
+        resultQueue.enqueue({encodeJob.position, encodeJob.version,
+                             network.serialize(chunkUpdate)});
+
+        // Release our hold on the chunk, so the map doesn't need to copy it
+        // when it's next modified.
+        encodeJob.chunk = nullptr;
+    }
+}
+
+void ChunkEncoder::addChunkToMessage(const EncodeJob& encodeJob,
+                                     ChunkUpdate& chunkUpdate)
+{
+    // Push the new chunk and get a ref to it.
+    chunkUpdate.chunks.emplace_back();
+    ChunkWireSnapshot& chunk{chunkUpdate.chunks.back()};
+
+    // Save the chunk's position.
+    chunk.x = static_cast<Uint16>(encodeJob.position.x);
+    chunk.y = static_cast<Uint16>(encodeJob.position.y);
+
+    // Copy all of each tile's layers to the snapshot, building the palette
+    // as we go.
+    paletteIndices.clear();
+    for (unsigned int i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
+        const Tile& tile{encodeJob.chunk->tiles[i]};
+        for (std::size_t j = 0; j < tile.layerCount; ++j) {
+            auto [paletteIt, didEmplace]{paletteIndices.try_emplace(
+                tile.spriteIDs[j],
+                static_cast<unsigned int>(chunk.palette.size()))};
+            if (didEmplace) {
+                chunk.palette.push_back(tile.spriteIDs[j]);
+            }
+
+            chunk.tiles[i].spriteLayers.push_back(
+                static_cast<Uint8>(paletteIt->second));
+        }
+    }
+}
+
+} // End namespace Server
+} // End namespace AM
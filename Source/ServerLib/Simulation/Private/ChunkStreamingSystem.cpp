@@ -4,12 +4,13 @@
 #include "ClientSimData.h"
 #include "Position.h"
 #include "PreviousPosition.h"
-#include "ChunkUpdate.h"
+#include "Config.h"
 #include "SharedConfig.h"
 #include "Serialize.h"
 #include "Log.h"
 #include <SDL_rect.h>
 #include "Tracy.hpp"
+#include <algorithm>
 #include <vector>
 
 namespace AM
@@ -21,6 +22,11 @@ ChunkStreamingSystem::ChunkStreamingSystem(
     Network& inNetwork)
 : world{inWorld}
 , network{inNetwork}
+, chunkCache{}
+, cacheRecency{}
+, chunkEncoder{inNetwork}
+, clientQueues{}
+, nextClientIndex{0}
 , chunkUpdateRequestQueue(inNetworkEventDispatcher)
 {
 }
@@ -29,61 +35,230 @@ void ChunkStreamingSystem::sendChunks()
 {
     ZoneScoped;
 
-    // Process all chunk update requests.
+    // Cache any newly encoded chunks.
+    receiveEncodedChunks();
+
+    // Queue the chunks from all chunk update requests.
     ChunkUpdateRequest chunkUpdateRequest{};
     while (chunkUpdateRequestQueue.pop(chunkUpdateRequest)) {
-        sendChunkUpdate(chunkUpdateRequest);
+        queueRequestedChunks(chunkUpdateRequest);
+    }
+
+    // Send as many queued chunks as we can.
+    if (clientQueues.size() > 0) {
+        sendQueuedChunks();
     }
 }
 
-void ChunkStreamingSystem::sendChunkUpdate(
+void ChunkStreamingSystem::queueRequestedChunks(
     const ChunkUpdateRequest& chunkUpdateRequest)
 {
-    // Add the requested chunks to the message.
-    ChunkUpdate chunkUpdate{};
+    // If the client doesn't have an entity (it disconnected, or hasn't been
+    // admitted yet), skip the request.
+    NetworkID netID{chunkUpdateRequest.netID};
+    if (!(world.netIdMap.contains(netID))) {
+        return;
+    }
+    Uint32 generation{world.netIdMap.getGeneration(netID)};
+
+    // Find the client's queue, or add one if it doesn't have one.
+    auto queueIt{std::find_if(clientQueues.begin(), clientQueues.end(),
+                              [&](const ClientChunkQueue& clientQueue) {
+                                  return (clientQueue.netID == netID);
+                              })};
+    if (queueIt == clientQueues.end()) {
+        clientQueues.push_back({netID, generation, {}});
+        queueIt = (clientQueues.end() - 1);
+    }
+    else if (queueIt->generation != generation) {
+        // The queue belonged to a previous owner of this ID, clear it.
+        queueIt->generation = generation;
+        queueIt->chunks.clear();
+    }
+    std::vector<ChunkPosition>& queuedChunks{queueIt->chunks};
+
+    // Add each requested chunk to the queue.
+    const ChunkExtent& mapChunkExtent{world.tileMap.getChunkExtent()};
     for (const ChunkPosition& requestedChunk :
          chunkUpdateRequest.requestedChunks) {
-        addChunkToMessage(requestedChunk, chunkUpdate);
+        // If the chunk isn't in the map, skip it.
+        if (!(mapChunkExtent.containsPosition(requestedChunk))) {
+            LOG_INFO_RATE_LIMITED(
+                "Received request for out of bounds chunk: (%d, %d)",
+                requestedChunk.x, requestedChunk.y);
+            continue;
+        }
+
+        // If the chunk is already queued, skip it.
+        if (std::find(queuedChunks.begin(), queuedChunks.end(),
+                      requestedChunk)
+            != queuedChunks.end()) {
+            continue;
+        }
+
+        queuedChunks.push_back(requestedChunk);
+    }
+}
+
+void ChunkStreamingSystem::sendQueuedChunks()
+{
+    // Serve each client in turn until we run out of budget.
+    std::size_t bytesRemaining{Config::CHUNK_STREAMING_BYTES_PER_TICK};
+    std::size_t queueCount{clientQueues.size()};
+    std::size_t startIndex{nextClientIndex % queueCount};
+    std::size_t clientsServed{0};
+    while ((clientsServed < queueCount) && (bytesRemaining > 0)) {
+        ClientChunkQueue& clientQueue{
+            clientQueues[(startIndex + clientsServed) % queueCount]};
+        std::size_t bytesSent{sendClientChunks(clientQueue, bytesRemaining)};
+        bytesRemaining -= std::min(bytesSent, bytesRemaining);
+        clientsServed++;
+    }
+
+    // Start with the next unserved client on the next tick.
+    // Note: Its index will shift down by the number of queues before it that
+    //       are about to be removed. If it's also being removed, this lands
+    //       on the next remaining queue after it.
+    std::size_t nextQueueIndex{(startIndex + clientsServed) % queueCount};
+    nextClientIndex = 0;
+    for (std::size_t i = 0; i < nextQueueIndex; ++i) {
+        if (clientQueues[i].chunks.size() > 0) {
+            nextClientIndex++;
+        }
     }
 
-    // Send the message.
-    network.serializeAndSend(chunkUpdateRequest.netID, chunkUpdate);
+    // Remove any empty queues.
+    std::erase_if(clientQueues, [](const ClientChunkQueue& clientQueue) {
+        return (clientQueue.chunks.size() == 0);
+    });
 }
 
-void ChunkStreamingSystem::addChunkToMessage(const ChunkPosition& chunkPosition,
-                                             ChunkUpdate& chunkUpdate)
+std::size_t ChunkStreamingSystem::sendClientChunks(
+    ClientChunkQueue& clientQueue, std::size_t bytesRemaining)
 {
-    // Push the new chunk and get a ref to it.
-    chunkUpdate.chunks.emplace_back();
-    ChunkWireSnapshot& chunk{chunkUpdate.chunks.back()};
-
-    // Save the chunk's position.
-    chunk.x = chunkPosition.x;
-    chunk.y = chunkPosition.y;
-
-    // Calc what the chunk's starting tile is.
-    unsigned int startX{chunk.x * SharedConfig::CHUNK_WIDTH};
-    unsigned int startY{chunk.y * SharedConfig::CHUNK_WIDTH};
-
-    // For each tile in the chunk.
-    int tileIndex{0};
-    for (unsigned int tileY = 0; tileY < SharedConfig::CHUNK_WIDTH; ++tileY) {
-        for (unsigned int tileX = 0; tileX < SharedConfig::CHUNK_WIDTH;
-             ++tileX) {
-            // Copy all of the tile's layers to the snapshot.
-            const Tile& tile
-                = world.tileMap.getTile((startX + tileX), (startY + tileY));
-            for (const Tile::SpriteLayer& layer : tile.spriteLayers) {
-                unsigned int paletteID{
-                    chunk.getPaletteIndex(layer.sprite.numericID)};
-                chunk.tiles[tileIndex].spriteLayers.push_back(paletteID);
-            }
-
-            // Increment to the next linear index.
-            tileIndex++;
+    // If the client has disconnected (even if its ID was since reused), drop
+    // its queue.
+    auto entityIt{
+        world.netIdMap.find(clientQueue.netID, clientQueue.generation)};
+    if (entityIt == world.netIdMap.end()) {
+        clientQueue.chunks.clear();
+        return 0;
+    }
+
+    // Sort the queue so that the chunks closest to the client are at the
+    // end.
+    ChunkPosition centerChunk{
+        world.registry.get<Position>(entityIt->second).asChunkPosition()};
+    std::vector<ChunkPosition>& queuedChunks{clientQueue.chunks};
+    std::sort(queuedChunks.begin(), queuedChunks.end(),
+              [&centerChunk](const ChunkPosition& lhs,
+                             const ChunkPosition& rhs) {
+                  int lhsX{lhs.x - centerChunk.x};
+                  int lhsY{lhs.y - centerChunk.y};
+                  int rhsX{rhs.x - centerChunk.x};
+                  int rhsY{rhs.y - centerChunk.y};
+                  return ((lhsX * lhsX) + (lhsY * lhsY))
+                         > ((rhsX * rhsX) + (rhsY * rhsY));
+              });
+
+    // Send the closest chunks until we hit the budget.
+    std::size_t budget{std::min(Config::CHUNK_STREAMING_CLIENT_BYTES_PER_TICK,
+                                bytesRemaining)};
+    std::size_t bytesSent{0};
+    for (std::size_t i = queuedChunks.size(); i-- > 0;) {
+        // If this chunk is still being encoded, leave it in the queue.
+        BinaryBufferSharedPtr message{getChunkMessage(queuedChunks[i])};
+        if (message == nullptr) {
+            continue;
+        }
+
+        // If this chunk doesn't fit, wait for the next tick.
+        // Note: We always send at least 1 chunk, so a chunk that's larger
+        //       than the budget can't stall the queue.
+        if ((bytesSent > 0) && ((bytesSent + message->size()) > budget)) {
+            break;
+        }
+
+        network.send(clientQueue.netID, message);
+        bytesSent += message->size();
+        queuedChunks.erase(queuedChunks.begin() + i);
+    }
+
+    return bytesSent;
+}
+
+void ChunkStreamingSystem::receiveEncodedChunks()
+{
+    ChunkEncoder::EncodedChunk encodedChunk{};
+    while (chunkEncoder.popResult(encodedChunk)) {
+        // If the chunk was evicted while it was being encoded, drop the
+        // result. It'll be re-encoded if it's requested again.
+        auto cacheIt{chunkCache.find(encodedChunk.position)};
+        if (cacheIt == chunkCache.end()) {
+            continue;
+        }
+        CachedChunk& cachedChunk{cacheIt->second};
+
+        // Results arrive in the order that they were pushed, so this is
+        // always at least as new as what we have.
+        // Note: We replace the pointer instead of re-using the buffer, since
+        //       previously sent messages may still be waiting in a send
+        //       queue.
+        cachedChunk.version = encodedChunk.version;
+        cachedChunk.message = std::move(encodedChunk.message);
+        if (cachedChunk.encodingVersion == encodedChunk.version) {
+            cachedChunk.isEncoding = false;
         }
     }
 }
 
+BinaryBufferSharedPtr
+    ChunkStreamingSystem::getChunkMessage(const ChunkPosition& chunkPosition)
+{
+    // If we have an up-to-date message for this chunk, return it.
+    Uint32 currentVersion{world.tileMap.getChunkVersion(chunkPosition)};
+    CachedChunk& cachedChunk{touchCachedChunk(chunkPosition)};
+    if ((cachedChunk.message != nullptr)
+        && (cachedChunk.version == currentVersion)) {
+        return cachedChunk.message;
+    }
+
+    // The chunk has changed (or was never built). If we haven't already,
+    // push a snapshot of it to the encoder.
+    if (!(cachedChunk.isEncoding)
+        || (cachedChunk.encodingVersion != currentVersion)) {
+        chunkEncoder.pushJob({chunkPosition, currentVersion,
+                              world.tileMap.getChunkSnapshot(chunkPosition)});
+        cachedChunk.isEncoding = true;
+        cachedChunk.encodingVersion = currentVersion;
+    }
+
+    return nullptr;
+}
+
+ChunkStreamingSystem::CachedChunk&
+    ChunkStreamingSystem::touchCachedChunk(const ChunkPosition& chunkPosition)
+{
+    // If the chunk is already cached, move it to the front.
+    auto cacheIt{chunkCache.find(chunkPosition)};
+    if (cacheIt != chunkCache.end()) {
+        cacheRecency.splice(cacheRecency.begin(), cacheRecency,
+                            cacheIt->second.recencyIt);
+        return cacheIt->second;
+    }
+
+    // If the cache is full, evict the least recently used chunk.
+    if (chunkCache.size() >= Config::CHUNK_CACHE_MAX_CHUNKS) {
+        chunkCache.erase(cacheRecency.back());
+        cacheRecency.pop_back();
+    }
+
+    // Add the new entry.
+    cacheRecency.push_front(chunkPosition);
+    CachedChunk& cachedChunk{chunkCache[chunkPosition]};
+    cachedChunk.recencyIt = cacheRecency.begin();
+    return cachedChunk;
+}
+
 } // End namespace Server
 } // End namespace AM
@@ -2,6 +2,7 @@
 #include "Simulation.h"
 #include "World.h"
 #include "Network.h"
+#include "SimRegions.h"
 #include "Serialize.h"
 #include "ClientSimData.h"
 #include "BoundingBox.h"
@@ -19,10 +20,13 @@ namespace AM
 namespace Server
 {
 ClientAOISystem::ClientAOISystem(Simulation& inSimulation, World& inWorld,
-                                 Network& inNetwork)
+                                 Network& inNetwork,
+                                 SimRegions& inSimRegions)
 : simulation{inSimulation}
 , world(inWorld)
 , network(inNetwork)
+, simRegions{inSimRegions}
+, regionScratch(inSimRegions.getRegionCount())
 {
 }
 
@@ -30,64 +34,84 @@ void ClientAOISystem::updateAOILists()
 {
     ZoneScoped;
 
-    // Update every client entity's AOI list.
-    auto view{world.registry.view<ClientSimData, Position>()};
-    for (entt::entity entity : view) {
-        auto [client, position] = view.get<ClientSimData, Position>(entity);
-
-        // Clear our lists.
-        entitiesThatLeft.clear();
-        client.entitiesThatEnteredAOI.clear();
-
-        // Get the list of entities that are in this entity's AOI.
-        std::vector<entt::entity>& currentAOIEntities{
-            world.entityLocator.getEntitiesFine(
-                position, static_cast<unsigned int>(SharedConfig::AOI_RADIUS))};
-
-        // Remove this entity from the list, if it's in there.
-        // (We don't want to add it to its own list.)
-        auto entityIt{std::find(currentAOIEntities.begin(),
-                                currentAOIEntities.end(), entity)};
-        if (entityIt != currentAOIEntities.end()) {
-            currentAOIEntities.erase(entityIt);
+    // Update each region's client entities' AOI lists, in parallel.
+    // Note: Getting a view may modify the registry, so we get it here on the
+    //       sim thread. The region jobs only use const gets for everything
+    //       else.
+    auto clientView{world.registry.view<ClientSimData>()};
+    const entt::registry& registry{world.registry};
+    simRegions.run([&](std::size_t regionIndex) {
+        ZoneScopedN("ClientAOISystem::updateRegion");
+
+        RegionScratch& scratch{regionScratch[regionIndex]};
+        for (entt::entity entity : simRegions.getClientEntities(regionIndex)) {
+            updateClientAOI(entity, clientView.get<ClientSimData>(entity),
+                            registry.get<Position>(entity), scratch);
         }
+    });
+}
 
-        // Sort the list.
-        std::sort(currentAOIEntities.begin(), currentAOIEntities.end());
+void ClientAOISystem::updateClientAOI(entt::entity entity,
+                                      ClientSimData& client,
+                                      const Position& position,
+                                      RegionScratch& scratch)
+{
+    std::vector<entt::entity>& currentAOIEntities{scratch.currentAOIEntities};
+    std::vector<entt::entity>& entitiesThatLeft{scratch.entitiesThatLeft};
+
+    // Clear our lists.
+    entitiesThatLeft.clear();
+    client.entitiesThatEnteredAOI.clear();
+
+    // Get the list of entities that are in this entity's AOI.
+    // Note: Entities in neighboring regions are included, since the
+    //       locator covers the whole map.
+    world.entityLocator.getEntitiesFine(
+        position, static_cast<unsigned int>(SharedConfig::AOI_RADIUS),
+        currentAOIEntities);
+
+    // Remove this entity from the list, if it's in there.
+    // (We don't want to add it to its own list.)
+    auto entityIt{std::find(currentAOIEntities.begin(),
+                            currentAOIEntities.end(), entity)};
+    if (entityIt != currentAOIEntities.end()) {
+        currentAOIEntities.erase(entityIt);
+    }
 
-        // Fill entitiesThatLeft with the entities that left this entity's AOI.
-        std::vector<entt::entity>& oldAOIEntities{client.entitiesInAOI};
-        std::set_difference(oldAOIEntities.begin(), oldAOIEntities.end(),
-                            currentAOIEntities.begin(),
-                            currentAOIEntities.end(),
-                            std::back_inserter(entitiesThatLeft));
+    // Sort the list.
+    std::sort(currentAOIEntities.begin(), currentAOIEntities.end());
 
-        // Process the entities that left this entity's AOI.
-        if (entitiesThatLeft.size() > 0) {
-            processEntitiesThatLeft(client);
-        }
+    // Fill entitiesThatLeft with the entities that left this entity's AOI.
+    std::vector<entt::entity>& oldAOIEntities{client.entitiesInAOI};
+    std::set_difference(oldAOIEntities.begin(), oldAOIEntities.end(),
+                        currentAOIEntities.begin(),
+                        currentAOIEntities.end(),
+                        std::back_inserter(entitiesThatLeft));
 
-        // Fill entitiesThatEntered with the entities that entered this entity's
-        // AOI.
-        std::set_difference(currentAOIEntities.begin(),
-                            currentAOIEntities.end(), oldAOIEntities.begin(),
-                            oldAOIEntities.end(),
-                            std::back_inserter(client.entitiesThatEnteredAOI));
+    // Process the entities that left this entity's AOI.
+    if (entitiesThatLeft.size() > 0) {
+        processEntitiesThatLeft(client, entitiesThatLeft);
+    }
 
-        // Process the entities that entered this entity's AOI.
-        if (client.entitiesThatEnteredAOI.size() > 0) {
-            processEntitiesThatEntered(client);
-        }
+    // Fill entitiesThatEntered with the entities that entered this entity's
+    // AOI.
+    std::set_difference(currentAOIEntities.begin(),
+                        currentAOIEntities.end(), oldAOIEntities.begin(),
+                        oldAOIEntities.end(),
+                        std::back_inserter(client.entitiesThatEnteredAOI));
 
-        // Save the new list.
-        client.entitiesInAOI = currentAOIEntities;
+    // Process the entities that entered this entity's AOI.
+    if (client.entitiesThatEnteredAOI.size() > 0) {
+        processEntitiesThatEntered(client);
     }
+
+    // Save the new list.
+    client.entitiesInAOI = currentAOIEntities;
 }
 
-void ClientAOISystem::processEntitiesThatLeft(ClientSimData& client)
+void ClientAOISystem::processEntitiesThatLeft(
+    ClientSimData& client, const std::vector<entt::entity>& entitiesThatLeft)
 {
-    auto view{world.registry.view<ClientSimData>()};
-
     // Send the client an EntityDelete for each entity that left its AOI.
     for (entt::entity entityThatLeft : entitiesThatLeft) {
         network.serializeAndSend(
@@ -98,12 +122,12 @@ void ClientAOISystem::processEntitiesThatLeft(ClientSimData& client)
 
 void ClientAOISystem::processEntitiesThatEntered(ClientSimData& client)
 {
-    auto view{world.registry.view<ClientSimData, Name, Sprite>()};
+    const entt::registry& registry{world.registry};
 
     // Send the client an EntityInit for each entity that entered its AOI.
     for (entt::entity entityThatEntered : client.entitiesThatEnteredAOI) {
-        Name& enteredName{view.get<Name>(entityThatEntered)};
-        Sprite& enteredSprite{view.get<Sprite>(entityThatEntered)};
+        const Name& enteredName{registry.get<Name>(entityThatEntered)};
+        const Sprite& enteredSprite{registry.get<Sprite>(entityThatEntered)};
         network.serializeAndSend(client.netID,
                                  EntityInit{simulation.getCurrentTick(),
                                             entityThatEntered, enteredName.name,
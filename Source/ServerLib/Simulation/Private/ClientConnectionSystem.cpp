@@ -18,6 +18,7 @@
 #include "Transforms.h"
 #include "Log.h"
 #include "Tracy.hpp"
+#include <algorithm>
 
 namespace AM
 {
@@ -33,6 +34,11 @@ ClientConnectionSystem::ClientConnectionSystem(
 , spriteData{inSpriteData}
 , clientConnectedQueue{inNetworkEventDispatcher}
 , clientDisconnectedQueue{inNetworkEventDispatcher}
+, joinQueue{}
+, joinCount{0}
+, totalJoinWaitTicks{0}
+, maxJoinWaitTicks{0}
+, maxJoinQueueLength{0}
 {
 }
 
@@ -47,55 +53,134 @@ void ClientConnectionSystem::processConnectionEvents()
 
 void ClientConnectionSystem::processConnectEvents()
 {
-    // Add all newly connected client's entities to the sim.
-    for (unsigned int i = 0; i < clientConnectedQueue.size(); ++i) {
+    // Add all newly connected clients to the join queue.
+    Uint32 currentTick{simulation.getCurrentTick()};
+    std::size_t newJoinCount{clientConnectedQueue.size()};
+    for (std::size_t i = 0; i < newJoinCount; ++i) {
         ClientConnected clientConnected{};
         if (!(clientConnectedQueue.pop(clientConnected))) {
             LOG_FATAL("Expected element but pop failed.");
         }
 
-        /* Build their entity. */
-        // Find their spawn point.
-        entt::registry& registry{world.registry};
-        const Position spawnPoint{world.getSpawnPoint()};
-
-        // Create the entity and construct its standard components.
-        entt::entity newEntity{registry.create()};
-        registry.emplace<Name>(newEntity,
-                               std::to_string(static_cast<Uint32>(newEntity)));
-        Position& newPosition{registry.emplace<Position>(
-            newEntity, spawnPoint.x, spawnPoint.y, 0.0f)};
-        registry.emplace<PreviousPosition>(newEntity, spawnPoint.x,
-                                           spawnPoint.y, 0.0f);
-        registry.emplace<Velocity>(newEntity, 0.0f, 0.0f, 250.0f, 250.0f);
-        registry.emplace<Input>(newEntity);
-        registry.emplace<Rotation>(newEntity);
-        registry.emplace<ClientSimData>(newEntity, clientConnected.clientID,
-                                        std::vector<entt::entity>());
-        Sprite& newSprite{registry.emplace<Sprite>(
-            newEntity, spriteData.get(SharedConfig::DEFAULT_CHARACTER_SPRITE))};
-        Collision& collision{registry.emplace<Collision>(
-            newEntity, newSprite.modelBounds,
-            Transforms::modelToWorldCentered(newSprite.modelBounds,
-                                             newPosition))};
-
-        // Start tracking the entity in the locator.
-        // Note: Since the entity was added to the locator, its peers
-        //       will be told by ClientAOISystem to construct it.
-        world.entityLocator.setEntityLocation(newEntity, collision.worldBounds);
-
-        // Register the entity with the network ID map.
-        world.netIdMap[clientConnected.clientID] = newEntity;
-
-        LOG_INFO("Constructed entity with netID: %u, entityID: %u",
-                 clientConnected.clientID, newEntity);
-
-        // Build and send the response.
-        sendConnectionResponse(clientConnected.clientID, newEntity,
-                               spawnPoint.x, spawnPoint.y);
+        joinQueue.push_back({clientConnected.clientID, currentTick});
+    }
+    maxJoinQueueLength = std::max(maxJoinQueueLength, joinQueue.size());
+
+    // Spawn as many clients as we're allowed to this tick.
+    for (unsigned int i = 0;
+         (i < Config::MAX_JOINS_PER_TICK) && (joinQueue.size() > 0); ++i) {
+        spawnClient(joinQueue.front());
+        joinQueue.pop_front();
+    }
+
+    // If anyone is left waiting, update them on their position.
+    // Note: Newly queued clients are updated immediately, so they know
+    //       they're in the queue. The rest are updated periodically.
+    if (joinQueue.size() > 0) {
+        if ((currentTick % JOIN_QUEUE_UPDATE_TICKS) == 0) {
+            sendQueuePositions(joinQueue.size());
+        }
+        else {
+            sendQueuePositions(std::min(newJoinCount, joinQueue.size()));
+        }
+    }
+
+    reportJoinStats();
+}
+
+void ClientConnectionSystem::spawnClient(const PendingJoin& pendingJoin)
+{
+    /* Build their entity. */
+    // Find their spawn point.
+    entt::registry& registry{world.registry};
+    const Position spawnPoint{world.getSpawnPoint()};
+
+    // Create the entity and construct its standard components.
+    entt::entity newEntity{registry.create()};
+    registry.emplace<Name>(newEntity,
+                           std::to_string(static_cast<Uint32>(newEntity)));
+    Position& newPosition{registry.emplace<Position>(
+        newEntity, spawnPoint.x, spawnPoint.y, 0.0f)};
+    registry.emplace<PreviousPosition>(newEntity, spawnPoint.x, spawnPoint.y,
+                                       0.0f);
+    registry.emplace<Velocity>(newEntity, 0.0f, 0.0f, 250.0f, 250.0f);
+    registry.emplace<Input>(newEntity);
+    registry.emplace<Rotation>(newEntity);
+    registry.emplace<ClientSimData>(newEntity, pendingJoin.clientID,
+                                    std::vector<entt::entity>());
+    Sprite& newSprite{registry.emplace<Sprite>(
+        newEntity, spriteData.get(SharedConfig::DEFAULT_CHARACTER_SPRITE))};
+    Collision& collision{registry.emplace<Collision>(
+        newEntity, newSprite.modelBounds,
+        Transforms::modelToWorldCentered(newSprite.modelBounds,
+                                         newPosition))};
+
+    // Start tracking the entity in the locator.
+    // Note: Since the entity was added to the locator, its peers
+    //       will be told by ClientAOISystem to construct it.
+    world.entityLocator.setEntityLocation(newEntity, collision.worldBounds);
+
+    // Register the entity with the network ID map.
+    if (!(world.netIdMap.try_emplace(pendingJoin.clientID, newEntity)
+              .second)) {
+        LOG_FATAL("Network ID out of range or already in use: %u",
+                  pendingJoin.clientID);
+    }
+
+    // Record how long the client waited to join.
+    Uint32 waitTicks{simulation.getCurrentTick() - pendingJoin.connectedTick};
+    joinCount++;
+    totalJoinWaitTicks += waitTicks;
+    maxJoinWaitTicks = std::max(maxJoinWaitTicks, waitTicks);
+
+    LOG_INFO("Constructed entity with netID: %u, entityID: %u, waited: %u "
+             "ticks",
+             pendingJoin.clientID, newEntity, waitTicks);
+
+    // Build and send the response.
+    sendConnectionResponse(pendingJoin.clientID, newEntity, spawnPoint.x,
+                           spawnPoint.y);
+
+    // Now that the client is in the sim, let the network time it out.
+    network.setClientAdmitted(pendingJoin.clientID);
+}
+
+void ClientConnectionSystem::sendQueuePositions(std::size_t updateCount)
+{
+    std::size_t startIndex{joinQueue.size() - updateCount};
+    for (std::size_t i = startIndex; i < joinQueue.size(); ++i) {
+        ConnectionResponse connectionResponse{};
+        connectionResponse.tickNum = simulation.getCurrentTick();
+        connectionResponse.queuePosition = static_cast<Uint32>(i + 1);
+
+        // Note: We don't pass a tick, since this message shouldn't start the
+        //       client's tick confirmations.
+        network.serializeAndSend(joinQueue[i].clientID, connectionResponse);
     }
 }
 
+void ClientConnectionSystem::reportJoinStats()
+{
+    if ((simulation.getCurrentTick() % JOIN_STATS_REPORT_TICKS) != 0) {
+        return;
+    }
+
+    if (joinCount > 0) {
+        double meanWaitS{(static_cast<double>(totalJoinWaitTicks) / joinCount)
+                         * SharedConfig::SIM_TICK_TIMESTEP_S};
+        double maxWaitS{maxJoinWaitTicks * SharedConfig::SIM_TICK_TIMESTEP_S};
+        LOG_INFO("Joins: %u, mean wait: %.0fms, max wait: %.0fms, max queue "
+                 "length: %zu, still queued: %zu",
+                 joinCount, (meanWaitS * 1000), (maxWaitS * 1000),
+                 maxJoinQueueLength, joinQueue.size());
+    }
+
+    joinCount = 0;
+    totalJoinWaitTicks = 0;
+    maxJoinWaitTicks = 0;
+    maxJoinQueueLength = joinQueue.size();
+}
+
 void ClientConnectionSystem::processDisconnectEvents()
 {
     auto view{world.registry.view<ClientSimData>()};
@@ -107,6 +192,19 @@ void ClientConnectionSystem::processDisconnectEvents()
             LOG_FATAL("Expected element but pop failed.");
         }
 
+        // If the client was still waiting to join, remove it from the queue.
+        auto pendingJoinIt{std::find_if(
+            joinQueue.begin(), joinQueue.end(),
+            [&](const PendingJoin& pendingJoin) {
+                return (pendingJoin.clientID == clientDisconnected.clientID);
+            })};
+        if (pendingJoinIt != joinQueue.end()) {
+            joinQueue.erase(pendingJoinIt);
+            LOG_INFO("Removed netID: %u from the join queue.",
+                     clientDisconnected.clientID);
+            continue;
+        }
+
         // Find the disconnected client's associated entity.
         auto disconnectedEntityIt{
             world.netIdMap.find(clientDisconnected.clientID)};
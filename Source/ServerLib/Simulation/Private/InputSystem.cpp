@@ -1,24 +1,25 @@
 #include "InputSystem.h"
 #include "Simulation.h"
 #include "World.h"
-#include "Network.h"
-#include "Peer.h"
+#include "ClientInputRings.h"
 #include "Input.h"
+#include "IsMoving.h"
 #include "MovementStateNeedsSync.h"
 #include "ClientSimData.h"
+#include "NetworkStats.h"
 #include "Log.h"
+#include "entt/entity/registry.hpp"
 #include "Tracy.hpp"
-#include <memory>
 
 namespace AM
 {
 namespace Server
 {
 InputSystem::InputSystem(Simulation& inSimulation, World& inWorld,
-                         EventDispatcher& inNetworkEventDispatcher)
+                         ClientInputRings& inClientInputRings)
 : simulation{inSimulation}
 , world{inWorld}
-, inputChangeRequestQueue{inNetworkEventDispatcher}
+, clientInputRings{inClientInputRings}
 {
 }
 
@@ -26,95 +27,60 @@ void InputSystem::processInputMessages()
 {
     ZoneScoped;
 
-    // Sort any waiting client input events.
-    while (InputChangeRequest* inputChangeRequest
-           = inputChangeRequestQueue.peek()) {
-        // Push the event into the sorter.
-        SorterBase::ValidityResult result{inputChangeRequestSorter.push(
-            *inputChangeRequest, inputChangeRequest->tickNum)};
-
-        // If we had to drop an event, handle it.
-        if (result != SorterBase::ValidityResult::Valid) {
-            LOG_INFO("Dropped message from %u. Tick: %u, received: %u",
-                     inputChangeRequest->netID, simulation.getCurrentTick(),
-                     inputChangeRequest->tickNum);
-            handleDroppedMessage(inputChangeRequest->netID);
+    // Apply each client's input for this tick.
+    entt::registry& registry{world.registry};
+    Uint32 currentTick{simulation.getCurrentTick()};
+    auto view{registry.view<ClientSimData, Input>()};
+    for (auto [clientEntity, client, input] : view.each()) {
+        // If we had to drop one of this client's inputs, handle it.
+        if (clientInputRings.takeDropped(client.netID)) {
+            handleDroppedMessage(clientEntity);
         }
 
-        inputChangeRequestQueue.pop();
-    }
-
-    // Process all client input events for this tick.
-    std::queue<InputChangeRequest>& queue{
-        inputChangeRequestSorter.getCurrentQueue()};
-    while (!(queue.empty())) {
-        // Get the next event.
-        InputChangeRequest& inputChangeRequest{queue.front()};
-
-        // If the input is from an earlier tick, drop it and continue.
-        if (inputChangeRequest.tickNum < simulation.getCurrentTick()) {
-            LOG_INFO("Dropped message from %u. Tick: %u, received: %u",
-                     inputChangeRequest.netID, simulation.getCurrentTick(),
-                     inputChangeRequest.tickNum);
-            handleDroppedMessage(inputChangeRequest.netID);
-            inputChangeRequestQueue.pop();
+        // If the client didn't send an input for this tick, skip it.
+        Input newInput{};
+        if (!(clientInputRings.pop(client.netID, currentTick, newInput))) {
             continue;
         }
-        // If the message is from a later tick, we're done.
-        else if (inputChangeRequest.tickNum > simulation.getCurrentTick()) {
-            break;
+
+        // If the client's changes for this tick cancelled out (e.g. a press
+        // and release), there's nothing to process or sync.
+        if (newInput.inputStates == input.inputStates) {
+            NetworkStats::recordInputsCoalesced(1);
+            continue;
         }
 
-        // Find the entity associated with the given NetID.
-        auto clientEntityIt{world.netIdMap.find(inputChangeRequest.netID)};
+        // Update the entity's Input component.
+        input = newInput;
 
-        // Update the client entity's inputs.
-        if (clientEntityIt != world.netIdMap.end()) {
-            // Update the entity's Input component.
-            entt::entity clientEntity{clientEntityIt->second};
-            Input& input{world.registry.get<Input>(clientEntity)};
-            input = inputChangeRequest.input;
+        // Flag that the entity's movement needs to be processed.
+        registry.emplace_or_replace<IsMoving>(clientEntity);
 
-            // Flag that the entity's movement state needs to be synced.
-            if (!(world.registry.all_of<MovementStateNeedsSync>(
-                    clientEntity))) {
-                world.registry.emplace<MovementStateNeedsSync>(clientEntity);
-            }
+        // Flag that the entity's movement state needs to be synced.
+        if (!(registry.all_of<MovementStateNeedsSync>(clientEntity))) {
+            registry.emplace<MovementStateNeedsSync>(clientEntity);
         }
-        else {
-            // The entity was probably disconnected. Do nothing with the
-            // message.
-        }
-
-        queue.pop();
     }
-
-    // Advance the sorter to the next tick.
-    inputChangeRequestSorter.advance();
 }
 
-void InputSystem::handleDroppedMessage(NetworkID clientID)
+void InputSystem::handleDroppedMessage(entt::entity clientEntity)
 {
-    // Find the entity ID of the client that we dropped a message from.
-    auto clientEntityIt{world.netIdMap.find(clientID)};
-    if (clientEntityIt == world.netIdMap.end()) {
-        // The entity is gone, we don't need to process this drop.
-        return;
-    }
-
     entt::registry& registry{world.registry};
-    Input& entityInput{registry.get<Input>(clientEntityIt->second)};
+    Input& entityInput{registry.get<Input>(clientEntity)};
 
     // Default the entity's inputs so they don't run off a cliff.
     Input defaultInput{};
     if (entityInput.inputStates != defaultInput.inputStates) {
         entityInput.inputStates = defaultInput.inputStates;
+
+        // Flag that the entity's movement needs to be processed, so it can
+        // come to rest.
+        registry.emplace_or_replace<IsMoving>(clientEntity);
     }
 
     // Flag that the entity's movement state needs to be synced.
-    if (!(world.registry.all_of<MovementStateNeedsSync>(
-            clientEntityIt->second))) {
-        registry.emplace<MovementStateNeedsSync>(clientEntityIt->second);
+    if (!(registry.all_of<MovementStateNeedsSync>(clientEntity))) {
+        registry.emplace<MovementStateNeedsSync>(clientEntity);
     }
 }
 
@@ -1,6 +1,8 @@
 #include "MapSaveSystem.h"
 #include "World.h"
 #include "Config.h"
+#include "Log.h"
+#include "Tracy.hpp"
 
 namespace AM
 {
@@ -10,17 +12,207 @@ namespace Server
 MapSaveSystem::MapSaveSystem(World& inWorld)
 : world{inWorld}
 , saveTimer{}
+, journalTimer{}
+, savedChunkVersions{}
+, queuedChunkVersions{}
+, isSaving{false}
+, snapshotTimeS{0}
+, jobQueue{}
+, resultQueue{}
+, saveThreadObj{}
+, exitRequested{false}
 {
+    // The map was just loaded, so all chunks are already saved.
+    const ChunkExtent& chunkExtent{world.tileMap.getChunkExtent()};
+    savedChunkVersions.reserve(chunkExtent.getCount());
+    for (int y = 0; y < chunkExtent.yLength; ++y) {
+        for (int x = 0; x < chunkExtent.xLength; ++x) {
+            savedChunkVersions.push_back(
+                world.tileMap.getChunkVersion({x, y}));
+        }
+    }
+    queuedChunkVersions = savedChunkVersions;
+
+    // Start the save thread.
+    saveThreadObj = std::thread(&MapSaveSystem::saveSnapshots, this);
+}
+
+MapSaveSystem::~MapSaveSystem()
+{
+    // Note: If a save is in progress, the thread will finish it before
+    //       exiting. Any remaining changes will be saved by TileMap's
+    //       destructor.
+    exitRequested = true;
+    saveThreadObj.join();
 }
 
 void MapSaveSystem::saveMapIfNecessary()
 {
-    // If enough time has passed, save the map state to TileMap.bin.
-    if (saveTimer.getTime() >= Config::MAP_SAVE_PERIOD_S) {
-        world.tileMap.save("TileMap.bin");
+    // Log the results of any finished saves.
+    receiveSaveResults();
+
+    // If saving is disabled, don't start any new saves.
+    if (!(world.tileMap.getSavingEnabled())) {
+        return;
+    }
+
+    // If enough time has passed and we aren't still working on the last
+    // full save, start a new one.
+    if (!isSaving && (saveTimer.getTime() >= Config::MAP_SAVE_PERIOD_S)) {
+        startFullSave();
+    }
+    // Else if enough time has passed, journal any changed chunks.
+    else if (journalTimer.getTime() >= Config::MAP_JOURNAL_PERIOD_S) {
+        startJournalAppend();
+    }
+}
+
+void MapSaveSystem::startFullSave()
+{
+    Timer snapshotTimer{};
+
+    SaveJob saveJob{};
+    saveJob.isFullSave = true;
+    saveJob.saveSnapshot = world.tileMap.getSaveSnapshot();
 
-        saveTimer.reset();
+    // The full save covers every change so far.
+    const ChunkExtent& chunkExtent{world.tileMap.getChunkExtent()};
+    saveJob.chunkPositions.reserve(chunkExtent.getCount());
+    saveJob.chunkVersions.reserve(chunkExtent.getCount());
+    for (int y = 0; y < chunkExtent.yLength; ++y) {
+        for (int x = 0; x < chunkExtent.xLength; ++x) {
+            Uint32 currentVersion{world.tileMap.getChunkVersion({x, y})};
+            saveJob.chunkPositions.emplace_back(x, y);
+            saveJob.chunkVersions.push_back(currentVersion);
+            queuedChunkVersions[(y * chunkExtent.xLength) + x]
+                = currentVersion;
+        }
     }
+
+    jobQueue.enqueue(std::move(saveJob));
+
+    snapshotTimeS = snapshotTimer.getTime();
+
+    isSaving = true;
+    saveTimer.reset();
+    journalTimer.reset();
+}
+
+void MapSaveSystem::startJournalAppend()
+{
+    // Find the chunks that changed since they were last queued.
+    SaveJob saveJob{};
+    saveJob.isFullSave = false;
+    const ChunkExtent& chunkExtent{world.tileMap.getChunkExtent()};
+    for (int y = 0; y < chunkExtent.yLength; ++y) {
+        for (int x = 0; x < chunkExtent.xLength; ++x) {
+            Uint32& queuedVersion{
+                queuedChunkVersions[(y * chunkExtent.xLength) + x]};
+            Uint32 currentVersion{world.tileMap.getChunkVersion({x, y})};
+            if (queuedVersion != currentVersion) {
+                saveJob.chunkPositions.emplace_back(x, y);
+                saveJob.chunkVersions.push_back(currentVersion);
+                queuedVersion = currentVersion;
+            }
+        }
+    }
+
+    // If any chunks changed, pass them to the save thread.
+    if (saveJob.chunkPositions.size() > 0) {
+        saveJob.journalSnapshot
+            = world.tileMap.getJournalSnapshot(saveJob.chunkPositions);
+        jobQueue.enqueue(std::move(saveJob));
+    }
+
+    journalTimer.reset();
+}
+
+void MapSaveSystem::saveSnapshots()
+{
+    tracy::SetThreadName("MapSave");
+
+    SaveJob saveJob{};
+    while (!exitRequested) {
+        // Wait for a job.
+        if (!(jobQueue.wait_dequeue_timed(saveJob, JOB_WAIT_TIMEOUT_US))) {
+            continue;
+        }
+
+        ZoneScoped;
+
+        // Write the snapshot.
+        Timer timer{};
+        SaveResult saveResult{};
+        saveResult.isFullSave = saveJob.isFullSave;
+        if (saveJob.isFullSave) {
+            saveResult.wasSuccessful = world.tileMap.compactJournal(
+                saveJob.saveSnapshot, saveResult.bytesWritten);
+        }
+        else {
+            saveResult.wasSuccessful = world.tileMap.appendToJournal(
+                saveJob.journalSnapshot, saveResult.bytesWritten);
+        }
+        saveResult.saveTimeS = timer.getTime();
+        saveResult.chunkPositions = std::move(saveJob.chunkPositions);
+        saveResult.chunkVersions = std::move(saveJob.chunkVersions);
+
+        // Release our hold on the chunks, so the map doesn't need to copy
+        // them when they're next modified.
+        saveJob = {};
+
+        resultQueue.enqueue(saveResult);
+    }
+}
+
+void MapSaveSystem::receiveSaveResults()
+{
+    SaveResult saveResult{};
+    while (resultQueue.try_dequeue(saveResult)) {
+        for (std::size_t i = 0; i < saveResult.chunkPositions.size(); ++i) {
+            std::size_t chunkIndex{
+                getChunkIndex(saveResult.chunkPositions[i])};
+            Uint32 version{saveResult.chunkVersions[i]};
+
+            // If the write succeeded, the chunk is saved up to this version.
+            if (saveResult.wasSuccessful) {
+                savedChunkVersions[chunkIndex] = version;
+            }
+            // If it failed and a later job hasn't re-queued the chunk, reset
+            // it so the next journal pass will retry it.
+            // Note: Results arrive in the order that jobs were pushed, and
+            //       every job writes whole chunks, so a later job covers
+            //       any earlier versions.
+            else if (queuedChunkVersions[chunkIndex] == version) {
+                queuedChunkVersions[chunkIndex]
+                    = savedChunkVersions[chunkIndex];
+            }
+        }
+
+        if (saveResult.isFullSave) {
+            if (saveResult.wasSuccessful) {
+                LOG_INFO("Map saved in %.6fs (%.6fs on sim thread). Size: "
+                         "%u bytes.",
+                         saveResult.saveTimeS, snapshotTimeS,
+                         saveResult.bytesWritten);
+            }
+            else {
+                LOG_ERROR("Failed to save the map.");
+            }
+
+            isSaving = false;
+        }
+        else if (!(saveResult.wasSuccessful)) {
+            LOG_ERROR("Failed to append to the map journal.");
+        }
+    }
+}
+
+std::size_t
+    MapSaveSystem::getChunkIndex(const ChunkPosition& chunkPosition) const
+{
+    const ChunkExtent& chunkExtent{world.tileMap.getChunkExtent()};
+    return static_cast<std::size_t>((chunkPosition.y * chunkExtent.xLength)
+                                    + chunkPosition.x);
 }
 
 } // namespace Server
@@ -2,6 +2,7 @@
 #include "Simulation.h"
 #include "World.h"
 #include "Network.h"
+#include "SimRegions.h"
 #include "Serialize.h"
 #include "MovementUpdate.h"
 #include "Input.h"
@@ -11,18 +12,23 @@
 #include "ClientSimData.h"
 #include "MovementStateNeedsSync.h"
 #include "Log.h"
+#include "Config.h"
 #include "Tracy.hpp"
 #include <algorithm>
+#include <cmath>
 
 namespace AM
 {
 namespace Server
 {
 MovementSyncSystem::MovementSyncSystem(Simulation& inSimulation, World& inWorld,
-                                       Network& inNetwork)
+                                       Network& inNetwork,
+                                       SimRegions& inSimRegions)
 : simulation{inSimulation}
 , world{inWorld}
 , network{inNetwork}
+, simRegions{inSimRegions}
+, regionScratch(inSimRegions.getRegionCount())
 {
 }
 
@@ -31,69 +37,221 @@ void MovementSyncSystem::sendMovementUpdates()
     ZoneScoped;
 
     // Send clients the updated movement state of any nearby entities that have
-    // changed inputs, teleported, etc.
+    // changed inputs, teleported, etc. Each region's clients are processed in
+    // parallel.
+    // Note: Getting a view may modify the registry, so we get it here on the
+    //       sim thread. The region jobs only use const gets for everything
+    //       else.
     auto clientView{world.registry.view<ClientSimData>()};
-    for (entt::entity clientEntity : clientView) {
-        // Collect the entities that have updated state that is relevant to
-        // this client.
-        ClientSimData& client{clientView.get<ClientSimData>(clientEntity)};
-        collectEntitiesToSend(client, clientEntity);
-
-        // If there is updated state to send, send an update message.
-        if (entitiesToSend.size() > 0) {
-            sendEntityUpdate(client);
+    simRegions.run([&](std::size_t regionIndex) {
+        ZoneScopedN("MovementSyncSystem::updateRegion");
+
+        for (entt::entity clientEntity :
+             simRegions.getClientEntities(regionIndex)) {
+            updateClient(clientView.get<ClientSimData>(clientEntity),
+                         clientEntity, regionIndex);
         }
-    }
+    });
 
     // Clear the sync flags from every entity, since we just handled them.
+    // Note: This modifies the registry, so it must wait until every region
+    //       is done.
     world.registry.clear<MovementStateNeedsSync>();
 }
 
+void MovementSyncSystem::updateClient(ClientSimData& client,
+                                      entt::entity clientEntity,
+                                      std::size_t regionIndex)
+{
+    // Collect the entities that have updated state that is relevant to
+    // this client.
+    RegionScratch& scratch{regionScratch[regionIndex]};
+    collectEntitiesToSend(client, clientEntity, scratch);
+
+    // If there is updated state to send, send an update message.
+    if (scratch.entitiesToSend.size() > 0) {
+        sendEntityUpdate(client, scratch.entitiesToSend,
+                         simRegions.getTickArena(regionIndex));
+    }
+}
+
 void MovementSyncSystem::collectEntitiesToSend(ClientSimData& client,
-                                               entt::entity clientEntity)
+                                               entt::entity clientEntity,
+                                               RegionScratch& scratch)
 {
+    const entt::registry& registry{world.registry};
+    std::vector<entt::entity>& entitiesToSend{scratch.entitiesToSend};
+    std::vector<SyncCandidate>& syncCandidates{scratch.syncCandidates};
+
     /* Collect the entities that need to be sent to the client. */
     // Clear the vector.
     entitiesToSend.clear();
 
-    // Add all of the entities that just entered this client's AOI.
-    entitiesToSend.insert(entitiesToSend.end(),
-                          client.entitiesThatEnteredAOI.begin(),
-                          client.entitiesThatEnteredAOI.end());
+    // If the client entity itself needs to be synced, add it. The client's
+    // own entity is always sent immediately, regardless of budget.
+    if (registry.all_of<MovementStateNeedsSync>(clientEntity)) {
+        entitiesToSend.push_back(clientEntity);
+    }
+
+    // Add any newly changed entities to the client's pending list.
+    updatePendingSyncs(client, scratch);
+    if (client.pendingMovementSyncs.size() == 0) {
+        return;
+    }
 
-    // Add any entities in this client's AOI that need to be synced.
-    for (entt::entity entityInAOI : client.entitiesInAOI) {
-        if (world.registry.all_of<MovementStateNeedsSync>(entityInAOI)) {
-            entitiesToSend.push_back(entityInAOI);
+    // Gather the pending entities that are due to be sent on this tick.
+    Uint32 currentTick{simulation.getCurrentTick()};
+    const Position& clientPosition{registry.get<Position>(clientEntity)};
+    syncCandidates.clear();
+    for (std::size_t i = 0; i < client.pendingMovementSyncs.size(); ++i) {
+        ClientSimData::PendingSync& pendingSync{
+            client.pendingMovementSyncs[i]};
+
+        // Newly entered entities are always sent immediately, regardless of
+        // budget. ClientAOISystem already sent their init messages this
+        // tick, and the client would otherwise show them at a default
+        // position until their state arrived.
+        if (pendingSync.isInitial) {
+            entitiesToSend.push_back(pendingSync.entity);
+            pendingSync.entity = entt::null;
+            continue;
+        }
+
+        const Position& position{registry.get<Position>(pendingSync.entity)};
+        float xDistance{position.x - clientPosition.x};
+        float yDistance{position.y - clientPosition.y};
+        float distanceSquared{(xDistance * xDistance)
+                              + (yDistance * yDistance)};
+
+        // If this entity is far away and hasn't waited long enough, skip it.
+        Uint32 ticksWaited{currentTick - pendingSync.sinceTick + 1};
+        if (ticksWaited < getSyncInterval(distanceSquared)) {
+            continue;
         }
+
+        // Prioritize close and stale entities.
+        float priority{std::sqrt(distanceSquared)
+                       / static_cast<float>(ticksWaited)};
+        syncCandidates.push_back({i, priority});
     }
 
-    // If the client entity itself needs to be synced, add it.
-    if (world.registry.all_of<MovementStateNeedsSync>(clientEntity)) {
-        entitiesToSend.push_back(clientEntity);
+    // Sort the candidates by priority and send as many as fit in the budget.
+    std::sort(syncCandidates.begin(), syncCandidates.end(),
+              [](const SyncCandidate& lhs, const SyncCandidate& rhs) {
+                  return lhs.priority < rhs.priority;
+              });
+    std::size_t sendCount{std::min(
+        syncCandidates.size(),
+        (MAX_STATES_PER_SIM_TICK - std::min(entitiesToSend.size(),
+                                            MAX_STATES_PER_SIM_TICK)))};
+    for (std::size_t i = 0; i < sendCount; ++i) {
+        ClientSimData::PendingSync& pendingSync{
+            client.pendingMovementSyncs[syncCandidates[i].pendingIndex]};
+        entitiesToSend.push_back(pendingSync.entity);
+
+        // Mark this entry as sent so it gets removed below.
+        pendingSync.entity = entt::null;
     }
 
-    // Remove duplicates from the vector.
-    std::sort(entitiesToSend.begin(), entitiesToSend.end());
-    entitiesToSend.erase(
-        std::unique(entitiesToSend.begin(), entitiesToSend.end()),
-        entitiesToSend.end());
+    // Remove the sent entries from the pending list.
+    std::erase_if(client.pendingMovementSyncs,
+                  [](const ClientSimData::PendingSync& pendingSync) {
+                      return (pendingSync.entity == entt::null);
+                  });
+}
+
+void MovementSyncSystem::updatePendingSyncs(ClientSimData& client,
+                                            RegionScratch& scratch)
+{
+    const entt::registry& registry{world.registry};
+    std::vector<ClientSimData::PendingSync>& mergedPendingSyncs{
+        scratch.mergedPendingSyncs};
+    std::vector<ClientSimData::PendingSync>& pendingSyncs{
+        client.pendingMovementSyncs};
+    const std::vector<entt::entity>& enteredEntities{
+        client.entitiesThatEnteredAOI};
+    Uint32 currentTick{simulation.getCurrentTick()};
+
+    // Rebuild the pending list by walking the client's AOI.
+    // Note: entitiesInAOI and entitiesThatEnteredAOI are sorted by
+    //       ClientAOISystem, and we keep pendingSyncs sorted by entity, so
+    //       this is a single linear merge.
+    mergedPendingSyncs.clear();
+    std::size_t pendingIndex{0};
+    std::size_t enteredIndex{0};
+    for (entt::entity entityInAOI : client.entitiesInAOI) {
+        // Skip any pending entities that have left the client's AOI.
+        while ((pendingIndex < pendingSyncs.size())
+               && (pendingSyncs[pendingIndex].entity < entityInAOI)) {
+            pendingIndex++;
+        }
+        while ((enteredIndex < enteredEntities.size())
+               && (enteredEntities[enteredIndex] < entityInAOI)) {
+            enteredIndex++;
+        }
+        bool isPending{(pendingIndex < pendingSyncs.size())
+                       && (pendingSyncs[pendingIndex].entity == entityInAOI)};
+        bool justEntered{
+            (enteredIndex < enteredEntities.size())
+            && (enteredEntities[enteredIndex] == entityInAOI)};
+
+        if (isPending) {
+            // If an entity is already pending, we leave its tick alone so it
+            // doesn't lose its place. We'll send its latest state either way.
+            ClientSimData::PendingSync& pendingSync{
+                mergedPendingSyncs.emplace_back(pendingSyncs[pendingIndex])};
+            if (justEntered) {
+                pendingSync.isInitial = true;
+            }
+            pendingIndex++;
+        }
+        else if (justEntered) {
+            mergedPendingSyncs.push_back({entityInAOI, currentTick, true});
+        }
+        else if (registry.all_of<MovementStateNeedsSync>(entityInAOI)) {
+            mergedPendingSyncs.push_back({entityInAOI, currentTick, false});
+        }
+    }
+    pendingSyncs.swap(mergedPendingSyncs);
 
     // Clear entitiesThatEnteredAOI so they don't get added again next tick.
     client.entitiesThatEnteredAOI.clear();
 }
 
-void MovementSyncSystem::sendEntityUpdate(ClientSimData& client)
+unsigned int MovementSyncSystem::getSyncInterval(float distanceSquared)
+{
+    static constexpr float NEAR_RADIUS_SQUARED{
+        Config::MOVEMENT_SYNC_NEAR_RADIUS * Config::MOVEMENT_SYNC_NEAR_RADIUS};
+    static constexpr float MID_RADIUS_SQUARED{
+        Config::MOVEMENT_SYNC_MID_RADIUS * Config::MOVEMENT_SYNC_MID_RADIUS};
+
+    if (distanceSquared <= NEAR_RADIUS_SQUARED) {
+        return 1;
+    }
+    else if (distanceSquared <= MID_RADIUS_SQUARED) {
+        return Config::MOVEMENT_SYNC_MID_INTERVAL;
+    }
+    else {
+        return Config::MOVEMENT_SYNC_FAR_INTERVAL;
+    }
+}
+
+void MovementSyncSystem::sendEntityUpdate(
+    ClientSimData& client, const std::vector<entt::entity>& entitiesToSend,
+    std::pmr::memory_resource& tickArena)
 {
-    auto movementGroup{
-        world.registry.group<Input, Position, Velocity, Rotation>()};
-    MovementUpdate movementUpdate{};
+    // Note: Getting a group may modify the registry, so we use const gets.
+    const entt::registry& registry{world.registry};
+
+    // Note: The message only lives until it's serialized, so its states
+    //       are allocated from the tick arena.
+    MovementUpdate movementUpdate{.movementStates{&tickArena}};
+    movementUpdate.movementStates.reserve(entitiesToSend.size());
 
     // Add the entities to the message.
     for (entt::entity entityToSend : entitiesToSend) {
         auto [input, position, velocity, rotation]
-            = movementGroup.get<Input, Position, Velocity, Rotation>(
-                entityToSend);
+            = registry.get<Input, Position, Velocity, Rotation>(entityToSend);
         movementUpdate.movementStates.push_back(
             {entityToSend, input, position, velocity, rotation});
     }
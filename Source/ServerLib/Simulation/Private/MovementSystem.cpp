@@ -1,12 +1,14 @@
 #include "MovementSystem.h"
 #include "MovementHelpers.h"
 #include "World.h"
+#include "SimRegions.h"
 #include "Input.h"
 #include "Position.h"
 #include "PreviousPosition.h"
 #include "Velocity.h"
 #include "Rotation.h"
 #include "Collision.h"
+#include "IsMoving.h"
 #include "SharedConfig.h"
 #include "Transforms.h"
 #include "Log.h"
@@ -16,8 +18,11 @@ namespace AM
 {
 namespace Server
 {
-MovementSystem::MovementSystem(World& inWorld)
+MovementSystem::MovementSystem(World& inWorld, SimRegions& inSimRegions)
 : world(inWorld)
+, simRegions{inSimRegions}
+, movementGroup{nullptr}
+, regionBatches(inSimRegions.getRegionCount())
 {
 }
 
@@ -25,30 +30,94 @@ void MovementSystem::processMovements()
 {
     ZoneScoped;
 
-    // Move all entities that have the required components.
-    auto group = world.registry.group<Input, Position, PreviousPosition,
-                                      Velocity, Rotation, Collision>();
-    for (entt::entity entity : group) {
-        auto [input, position, previousPosition, velocity, rotation, collision]
-            = group.get<Input, Position, PreviousPosition, Velocity, Rotation,
+    // Gather all entities that are flagged as moving, sorting them into
+    // regions by their current position.
+    // Note: Idle entities aren't flagged, so they cost nothing here.
+    // Note: Entities are assigned to a region each tick, so an entity that
+    //       crosses a border is simply picked up by the next region on the
+    //       following tick.
+    entt::registry& registry{world.registry};
+    EnttGroups::MovementGroup group{
+        registry.group<Input, Position, PreviousPosition, Velocity, Rotation,
+                       Collision>()};
+    auto movingView = registry.view<IsMoving>();
+    for (MovementBatch& regionBatch : regionBatches) {
+        regionBatch.clear();
+    }
+    for (entt::entity entity : movingView) {
+        auto [input, position, velocity, rotation]
+            = group.get<Input, Position, Velocity, Rotation>(entity);
+        std::size_t regionIndex{simRegions.getRegionIndex(position)};
+        regionBatches[regionIndex].push(entity, input, position, velocity,
+                                        rotation);
+    }
+
+    // Move each region's entities, in parallel.
+    movementGroup = &group;
+    simRegions.run(
+        [this](std::size_t regionIndex) { moveRegion(regionIndex); });
+    movementGroup = nullptr;
+
+    // Update the locator and IsMoving tags.
+    // Note: These aren't partitioned by region, so they're updated here on
+    //       the sim thread.
+    for (MovementBatch& regionBatch : regionBatches) {
+        for (entt::entity entity : regionBatch.entities) {
+            auto [position, previousPosition, velocity, collision]
+                = group.get<Position, PreviousPosition, Velocity, Collision>(
+                    entity);
+
+            // If they did actually move, update their position in the
+            // locator.
+            if (position != previousPosition) {
+                world.entityLocator.setEntityLocation(entity,
+                                                      collision.worldBounds);
+            }
+            // Else if they've come to rest, stop processing them.
+            else if ((velocity.x == 0) && (velocity.y == 0)) {
+                registry.remove<IsMoving>(entity);
+            }
+        }
+    }
+}
+
+void MovementSystem::moveRegion(std::size_t regionIndex)
+{
+    ZoneScoped;
+
+    // Note: This may run on a worker thread. It only writes to the
+    //       components of the entities in this region's batch, and only
+    //       reads the tile map, so regions don't conflict.
+    // Note: We use the group that processMovements() got, since getting it
+    //       here would touch the registry from multiple threads.
+    MovementBatch& movementBatch{regionBatches[regionIndex]};
+    EnttGroups::MovementGroup& group{*movementGroup};
+
+    // Update their velocities, positions, and rotations, based on their
+    // current inputs.
+    MovementHelpers::updateBatch(movementBatch,
+                                 SharedConfig::SIM_TICK_TIMESTEP_S);
+
+    // Apply the results.
+    for (std::size_t i = 0; i < movementBatch.size(); ++i) {
+        entt::entity entity{movementBatch.entities[i]};
+        auto [position, previousPosition, velocity, rotation, collision]
+            = group.get<Position, PreviousPosition, Velocity, Rotation,
                         Collision>(entity);
 
         // Save their old position.
         previousPosition = position;
 
-        // Update their velocity for this tick, based on their current inputs.
-        velocity = MovementHelpers::updateVelocity(
-            velocity, input.inputStates, SharedConfig::SIM_TICK_TIMESTEP_S);
-
-        // Calculate their desired position, using the new velocity.
-        Position desiredPosition{position};
-        desiredPosition = MovementHelpers::updatePosition(
-            desiredPosition, velocity, SharedConfig::SIM_TICK_TIMESTEP_S);
-
-        // Update the direction they're facing, based on their current inputs.
-        rotation = MovementHelpers::updateRotation(rotation, input.inputStates);
+        velocity.x = movementBatch.velocityXs[i];
+        velocity.y = movementBatch.velocityYs[i];
+        rotation.direction = static_cast<Rotation::Direction>(
+            movementBatch.directions[i]);
 
         // If they're trying to move, resolve collisions.
+        // Note: Only entities whose desired position changed pay for this.
+        Position desiredPosition{position};
+        desiredPosition.x = movementBatch.positionXs[i];
+        desiredPosition.y = movementBatch.positionYs[i];
         if (desiredPosition != position) {
             // Calculate a new bounding box to match their desired position.
             BoundingBox desiredBounds{Transforms::modelToWorldCentered(
@@ -65,13 +134,6 @@ void MovementSystem::processMovements()
                          - collision.worldBounds.getMinPosition());
             collision.worldBounds = resolvedBounds;
         }
-
-        // If they did actually move.
-        if (position != previousPosition) {
-            // Update their position in the locator.
-            world.entityLocator.setEntityLocation(entity,
-                                                  collision.worldBounds);
-        }
     }
 }
 
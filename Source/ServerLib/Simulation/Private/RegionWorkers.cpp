@@ -0,0 +1,96 @@
+#include "RegionWorkers.h"
+#include "Log.h"
+
+namespace AM
+{
+namespace Server
+{
+RegionWorkers::RegionWorkers(std::size_t inRegionCount)
+: currentJob{nullptr}
+, workerThreads{}
+, roundNumber{0}
+, workersRemaining{0}
+, exitRequested{false}
+{
+    if (inRegionCount == 0) {
+        LOG_FATAL("Region count must be at least 1.");
+    }
+
+    // Start a worker for each region after the first.
+    for (std::size_t i = 1; i < inRegionCount; ++i) {
+        workerThreads.emplace_back(&RegionWorkers::processRegion, this, i);
+    }
+}
+
+RegionWorkers::~RegionWorkers()
+{
+    {
+        std::unique_lock lock{workerMutex};
+        exitRequested = true;
+    }
+    startCondVar.notify_all();
+
+    for (std::thread& workerThread : workerThreads) {
+        workerThread.join();
+    }
+}
+
+void RegionWorkers::run(const std::function<void(std::size_t)>& regionJob)
+{
+    // If there's only 1 region, we don't need to involve any other threads.
+    if (workerThreads.size() == 0) {
+        regionJob(0);
+        return;
+    }
+
+    // Wake the workers.
+    {
+        std::unique_lock lock{workerMutex};
+        currentJob = &regionJob;
+        roundNumber++;
+        workersRemaining = workerThreads.size();
+    }
+    startCondVar.notify_all();
+
+    // Process the first region on this thread.
+    regionJob(0);
+
+    // Wait for the workers to finish.
+    std::unique_lock lock{workerMutex};
+    doneCondVar.wait(lock, [this] { return (workersRemaining == 0); });
+    currentJob = nullptr;
+}
+
+void RegionWorkers::processRegion(std::size_t regionIndex)
+{
+    tracy::SetThreadName("SimRegionWorker");
+
+    Uint64 lastRoundNumber{0};
+    while (true) {
+        // Wait until run() starts a new round.
+        const std::function<void(std::size_t)>* regionJob{nullptr};
+        {
+            std::unique_lock lock{workerMutex};
+            startCondVar.wait(lock, [&] {
+                return (exitRequested || (roundNumber != lastRoundNumber));
+            });
+            if (exitRequested) {
+                return;
+            }
+            lastRoundNumber = roundNumber;
+            regionJob = currentJob;
+        }
+
+        (*regionJob)(regionIndex);
+
+        // Signal that we're done. If we're the last one, wake run().
+        std::unique_lock lock{workerMutex};
+        workersRemaining--;
+        if (workersRemaining == 0) {
+            doneCondVar.notify_one();
+        }
+    }
+}
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,94 @@
+#include "SimRegions.h"
+#include "World.h"
+#include "ClientSimData.h"
+#include "Position.h"
+#include "SharedConfig.h"
+#include "Config.h"
+#include "Tracy.hpp"
+#include <algorithm>
+
+namespace AM
+{
+namespace Server
+{
+SimRegions::SimRegions(World& inWorld)
+: world{inWorld}
+, regionWidth{0}
+, regionHeight{0}
+, regionClients(getRegionCount())
+, regionTickArenas{}
+, regionWorkers{getRegionCount()}
+{
+    // Split the map into equal-sized regions.
+    const TileExtent& mapExtent{world.tileMap.getTileExtent()};
+    regionWidth
+        = static_cast<float>(mapExtent.xLength * SharedConfig::TILE_WORLD_WIDTH)
+          / static_cast<float>(Config::SIM_REGION_COLUMNS);
+    regionHeight
+        = static_cast<float>(mapExtent.yLength * SharedConfig::TILE_WORLD_WIDTH)
+          / static_cast<float>(Config::SIM_REGION_ROWS);
+
+    for (std::size_t i = 0; i < getRegionCount(); ++i) {
+        regionTickArenas.push_back(
+            std::make_unique<TickArena>(TICK_ARENA_INITIAL_SIZE));
+    }
+}
+
+std::size_t SimRegions::getRegionCount() const
+{
+    return (Config::SIM_REGION_COLUMNS * Config::SIM_REGION_ROWS);
+}
+
+std::size_t SimRegions::getRegionIndex(const Position& position) const
+{
+    int column{std::clamp(static_cast<int>(position.x / regionWidth), 0,
+                          static_cast<int>(Config::SIM_REGION_COLUMNS) - 1)};
+    int row{std::clamp(static_cast<int>(position.y / regionHeight), 0,
+                       static_cast<int>(Config::SIM_REGION_ROWS) - 1)};
+    return static_cast<std::size_t>((row * Config::SIM_REGION_COLUMNS)
+                                    + column);
+}
+
+void SimRegions::updateClientOwnership()
+{
+    ZoneScoped;
+
+    for (std::vector<entt::entity>& clientEntities : regionClients) {
+        clientEntities.clear();
+    }
+
+    // Give each client to the region that it's in.
+    // Note: Rebuilding the lists is cheap compared to the per-client work
+    //       that the regions do, and it means disconnected clients never
+    //       linger in them.
+    auto view{world.registry.view<ClientSimData, Position>()};
+    for (auto [entity, client, position] : view.each()) {
+        regionClients[getRegionIndex(position)].push_back(entity);
+    }
+}
+
+const std::vector<entt::entity>&
+    SimRegions::getClientEntities(std::size_t regionIndex) const
+{
+    return regionClients[regionIndex];
+}
+
+TickArena& SimRegions::getTickArena(std::size_t regionIndex)
+{
+    return *(regionTickArenas[regionIndex]);
+}
+
+void SimRegions::run(const std::function<void(std::size_t)>& regionJob)
+{
+    regionWorkers.run(regionJob);
+}
+
+void SimRegions::resetTickArenas()
+{
+    for (std::unique_ptr<TickArena>& tickArena : regionTickArenas) {
+        tickArena->reset();
+    }
+}
+
+} // End namespace Server
+} // End namespace AM
@@ -15,14 +15,19 @@ Simulation::Simulation(Network& inNetwork, SpriteData& inSpriteData)
 : network{inNetwork}
 , world{inSpriteData}
 , currentTick{0}
+, systemTimer{}
+, systemTimings{}
+, tickArena{TICK_ARENA_INITIAL_SIZE}
+, simRegions{world}
 , extension{nullptr}
 , clientConnectionSystem{*this, world, network.getEventDispatcher(), network,
                          inSpriteData}
-, tileUpdateSystem{world, network.getEventDispatcher(), network, extension}
-, clientAOISystem{*this, world, network}
-, inputSystem{*this, world, network.getEventDispatcher()}
-, movementSystem{world}
-, movementSyncSystem{*this, world, network}
+, tileUpdateSystem{world, network.getEventDispatcher(), network, extension,
+                   tickArena}
+, clientAOISystem{*this, world, network, simRegions}
+, inputSystem{*this, world, network.getClientInputRings()}
+, movementSystem{world, simRegions}
+, movementSyncSystem{*this, world, network, simRegions}
 , chunkStreamingSystem{world, network.getEventDispatcher(), network}
 , mapSaveSystem{world}
 {
@@ -45,10 +50,14 @@ void Simulation::tick()
     }
 
     // Process client connections and disconnections.
+    systemTimer.reset();
     clientConnectionSystem.processConnectionEvents();
+    systemTimings.clientConnection = systemTimer.getTime();
 
     // Receive and process tile update requests.
+    systemTimer.reset();
     tileUpdateSystem.updateTiles();
+    systemTimings.tileUpdate = systemTimer.getTime();
 
     // Call the project's pre-movement logic.
     if (extension != nullptr) {
@@ -56,24 +65,37 @@ void Simulation::tick()
     }
 
     // Send updated tile state to nearby clients.
+    systemTimer.reset();
     tileUpdateSystem.sendTileUpdates();
+    systemTimings.tileUpdate += systemTimer.getTime();
 
     // Receive and process client input messages.
+    systemTimer.reset();
     inputSystem.processInputMessages();
+    systemTimings.input = systemTimer.getTime();
 
     // Move all of our entities.
+    systemTimer.reset();
     movementSystem.processMovements();
+    systemTimings.movement = systemTimer.getTime();
 
     // Call the project's post-movement logic.
     if (extension != nullptr) {
         extension->afterMovement();
     }
 
+    // Hand off any clients that crossed a region border to their new region.
+    systemTimer.reset();
+    simRegions.updateClientOwnership();
+
     // Update each client entity's "entities in my AOI" list.
     clientAOISystem.updateAOILists();
+    systemTimings.clientAOI = systemTimer.getTime();
 
     // Synchronize entity movement state with the clients.
+    systemTimer.reset();
     movementSyncSystem.sendMovementUpdates();
+    systemTimings.movementSync = systemTimer.getTime();
 
     // Call the project's post-movement-sync logic.
     if (extension != nullptr) {
@@ -81,10 +103,18 @@ void Simulation::tick()
     }
 
     // Respond to chunk data requests.
+    systemTimer.reset();
     chunkStreamingSystem.sendChunks();
+    systemTimings.chunkStreaming = systemTimer.getTime();
 
     // If enough time has passed, save the world's tile map state.
+    systemTimer.reset();
     mapSaveSystem.saveMapIfNecessary();
+    systemTimings.mapSave = systemTimer.getTime();
+
+    // Free this tick's scratch data.
+    tickArena.reset();
+    simRegions.resetTickArenas();
 
     currentTick++;
 }
@@ -99,6 +129,11 @@ Uint32 Simulation::getCurrentTick()
     return currentTick;
 }
 
+const Simulation::SystemTimings& Simulation::getSystemTimings() const
+{
+    return systemTimings;
+}
+
 void Simulation::setExtension(std::unique_ptr<ISimulationExtension> inExtension)
 {
     extension = std::move(inExtension);
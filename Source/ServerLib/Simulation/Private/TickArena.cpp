@@ -0,0 +1,70 @@
+#include "TickArena.h"
+#include "Log.h"
+
+namespace AM
+{
+namespace Server
+{
+TickArena::TickArena(std::size_t inInitialSize)
+: buffer{std::make_unique<std::byte[]>(inInitialSize)}
+, bufferSize{inInitialSize}
+, overflowResource{}
+, bufferResource{}
+{
+    bufferResource.emplace(buffer.get(), bufferSize, &overflowResource);
+}
+
+void TickArena::reset()
+{
+    // Free everything that was allocated this tick.
+    bufferResource->release();
+
+    // If we overflowed, grow the buffer so that the next tick fits.
+    if (overflowResource.bytesAllocated > 0) {
+        bufferSize += overflowResource.bytesAllocated;
+        LOG_INFO("Tick arena overflowed. Growing to %zu bytes.", bufferSize);
+
+        bufferResource.reset();
+        buffer = std::make_unique<std::byte[]>(bufferSize);
+        bufferResource.emplace(buffer.get(), bufferSize, &overflowResource);
+        overflowResource.bytesAllocated = 0;
+    }
+}
+
+void* TickArena::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    return bufferResource->allocate(bytes, alignment);
+}
+
+void TickArena::do_deallocate(void*, std::size_t, std::size_t)
+{
+    // Memory is only freed by reset().
+}
+
+bool TickArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return (this == &other);
+}
+
+void* TickArena::OverflowResource::do_allocate(std::size_t bytes,
+                                               std::size_t alignment)
+{
+    bytesAllocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void TickArena::OverflowResource::do_deallocate(void* p, std::size_t bytes,
+                                                std::size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool TickArena::OverflowResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+    return (this == &other);
+}
+
+} // End namespace Server
+} // End namespace AM
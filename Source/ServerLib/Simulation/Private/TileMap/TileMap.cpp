@@ -6,11 +6,23 @@
 #include "Deserialize.h"
 #include "ByteTools.h"
 #include "TileMapSnapshot.h"
+#include "MapJournalEntry.h"
+#include "MappedFile.h"
+#include "FileSync.h"
 #include "SharedConfig.h"
 #include "Timer.h"
 #include "Log.h"
 #include "AMAssert.h"
 #include "Ignore.h"
+#include <filesystem>
+#include <system_error>
+#include <fstream>
+#include <iterator>
+#include <array>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <algorithm>
 
 namespace AM
 {
@@ -18,160 +30,664 @@ namespace Server
 {
 TileMap::TileMap(SpriteData& inSpriteData)
 : TileMapBase{inSpriteData, true}
+, savingEnabled{true}
 {
     // Prime a timer.
     Timer timer;
 
-    // Deserialize the file into a snapshot.
-    TileMapSnapshot mapSnapshot;
-    std::string mapPath{Paths::BASE_PATH + "TileMap.bin"};
-    if (!Deserialize::fromFile(mapPath, mapSnapshot)) {
-        LOG_FATAL("Failed to deserialize map at path: %s", mapPath.c_str());
+    // If we crashed while compacting the journal, clean up after it.
+    recoverCompaction();
+
+    // Map the file and load it, based on its format version.
+    std::string mapPath{Paths::BASE_PATH + MAP_FILE_NAME};
+    bool needsUpgrade{false};
+    {
+        MappedFile mapFile{mapPath};
+        if (!(mapFile.isOpen()) || (mapFile.size() < sizeof(Uint16))) {
+            LOG_FATAL("Failed to open map at path: %s", mapPath.c_str());
+        }
+
+        Uint16 version{ByteTools::read16(mapFile.data())};
+        if (version == MAP_FORMAT_VERSION) {
+            loadVersion1(mapFile.data(), mapFile.size());
+        }
+        else if (version == 0) {
+            needsUpgrade = true;
+        }
+        else {
+            LOG_FATAL("Unsupported map format version: %u", version);
+        }
+    }
+    if (needsUpgrade) {
+        loadVersion0(mapPath);
     }
 
-    // Load the map snapshot.
-    load(mapSnapshot);
+    // Apply any changes that were journaled since the last full save.
+    replayJournal();
 
-    // Print the time taken.
+    // Print the time taken and our throughput.
     double timeTaken{timer.getTime()};
-    LOG_INFO("Map loaded in %.6fs. Size: (%u, %u)ch.", timeTaken,
-             chunkExtent.xLength, chunkExtent.yLength);
+    std::size_t loadedChunkCount{getResidentChunkCount()};
+    LOG_INFO("Map loaded in %.6fs. Size: (%u, %u)ch. Loaded %u chunks "
+             "(%.0f chunks/s).",
+             timeTaken, chunkExtent.xLength, chunkExtent.yLength,
+             loadedChunkCount,
+             (static_cast<double>(loadedChunkCount) / timeTaken));
+
+    // If the map file was in an old format, replace it.
+    if (needsUpgrade) {
+        LOG_INFO("Upgrading map file to format version %u.",
+                 MAP_FORMAT_VERSION);
+        std::size_t bytesWritten{0};
+        if (!compactJournal(getSaveSnapshot(), bytesWritten)) {
+            LOG_FATAL("Failed to upgrade the map file.");
+        }
+    }
 }
 
 TileMap::~TileMap()
 {
-    // Save the map state to TileMap.bin.
-    save("TileMap.bin");
-}
+    if (!savingEnabled) {
+        return;
+    }
 
-void TileMap::save(const std::string& fileName)
-{
     LOG_INFO("Saving map...");
 
     // Prime a timer.
     Timer timer;
 
-    /* Save this map's state into a snapshot. */
-    // Save the header data.
-    TileMapSnapshot mapSnapshot{};
-    mapSnapshot.version = MAP_FORMAT_VERSION;
-    mapSnapshot.xLengthChunks = chunkExtent.xLength;
-    mapSnapshot.yLengthChunks = chunkExtent.yLength;
-
-    // Allocate room for our chunks.
-    mapSnapshot.chunks.resize(chunkExtent.getCount());
-
-    // Save our tiles into the snapshot as chunks.
-    unsigned int startLinearTileIndex{0};
-    int chunksProcessed{0};
-    for (unsigned int i = 0; i < chunkExtent.getCount(); ++i) {
-        ChunkSnapshot& chunk{mapSnapshot.chunks[i]};
-
-        // Process each tile in this chunk.
-        unsigned int nextLinearTileIndex{startLinearTileIndex};
-        unsigned int tilesProcessed{0};
-        for (unsigned int j = 0; j < SharedConfig::CHUNK_TILE_COUNT; ++j) {
-            // Copy all of the tile's layers into the snapshot.
-            TileSnapshot& tile{chunk.tiles[j]};
-            for (Tile::SpriteLayer& layer :
-                 tiles[nextLinearTileIndex].spriteLayers) {
-                const std::string& stringID{
-                    spriteData.getStringID(layer.sprite.numericID)};
-                unsigned int paletteID{chunk.getPaletteIndex(stringID)};
-                tile.spriteLayers.push_back(paletteID);
-            }
+    // Save the map state to TileMap.bin, folding in the journal.
+    std::size_t bytesWritten{0};
+    if (compactJournal(getSaveSnapshot(), bytesWritten)) {
+        // Print the time taken.
+        double timeTaken{timer.getTime()};
+        LOG_INFO("Map saved in %.6fs. Size: %u bytes.", timeTaken,
+                 bytesWritten);
+    }
+    else {
+        LOG_FATAL("Failed to serialize and save the map.");
+    }
+}
 
-            // Increment to the next tile.
-            nextLinearTileIndex++;
+void TileMap::setSavingEnabled(bool inSavingEnabled)
+{
+    savingEnabled = inSavingEnabled;
+}
 
-            // If we've processed all the tiles in this row, increment to the
-            // next row.
-            tilesProcessed++;
-            if (tilesProcessed == SharedConfig::CHUNK_WIDTH) {
-                nextLinearTileIndex
-                    += (tileExtent.xLength - SharedConfig::CHUNK_WIDTH);
-                tilesProcessed = 0;
-            }
+bool TileMap::getSavingEnabled() const
+{
+    return savingEnabled;
+}
+
+TileMap::SaveSnapshot TileMap::getSaveSnapshot() const
+{
+    SaveSnapshot snapshot{};
+    snapshot.chunkExtent = chunkExtent;
+    snapshot.chunks.assign(chunks.begin(), chunks.end());
+    return snapshot;
+}
+
+TileMap::JournalSnapshot TileMap::getJournalSnapshot(
+    const std::vector<ChunkPosition>& chunkPositions) const
+{
+    JournalSnapshot snapshot{};
+    snapshot.chunkPositions = chunkPositions;
+    snapshot.chunks.reserve(chunkPositions.size());
+    for (const ChunkPosition& chunkPosition : chunkPositions) {
+        snapshot.chunks.push_back(getChunkSnapshot(chunkPosition));
+    }
+
+    return snapshot;
+}
+
+bool TileMap::appendToJournal(const JournalSnapshot& snapshot,
+                              std::size_t& bytesWritten) const
+{
+    // Serialize each chunk into a size-prefixed entry.
+    std::vector<Uint8> journalBytes{};
+    for (std::size_t i = 0; i < snapshot.chunks.size(); ++i) {
+        MapJournalEntry journalEntry{};
+        journalEntry.chunkX = snapshot.chunkPositions[i].x;
+        journalEntry.chunkY = snapshot.chunkPositions[i].y;
+        if (snapshot.chunks[i] != emptyChunk) {
+            saveChunk(*(snapshot.chunks[i]), journalEntry.chunkSnapshot);
         }
 
-        // Increment to the next chunk.
-        startLinearTileIndex += SharedConfig::CHUNK_WIDTH;
+        std::size_t entryStart{journalBytes.size()};
+        std::size_t entrySize{Serialize::measureSize(journalEntry)};
+        journalBytes.resize(entryStart + sizeof(Uint32) + entrySize);
+        ByteTools::write32(static_cast<Uint32>(entrySize),
+                           &(journalBytes[entryStart]));
+        Serialize::toBuffer(journalBytes.data(), journalBytes.size(),
+                            journalEntry, (entryStart + sizeof(Uint32)));
+    }
+
+    // Append the entries to the journal.
+    // Note: If we crash partway through this write, the last entry will be
+    //       truncated and ignored when the journal is replayed.
+    std::string journalPath{Paths::BASE_PATH + JOURNAL_FILE_NAME};
+    std::error_code errorCode{};
+    bool journalExisted{std::filesystem::exists(journalPath, errorCode)};
+    std::ofstream journalFile(journalPath, (std::ios::binary | std::ios::app));
+    if (!(journalFile.is_open())) {
+        LOG_ERROR("Failed to open file: %s", journalPath.c_str());
+        return false;
+    }
+    journalFile.write(reinterpret_cast<const char*>(journalBytes.data()),
+                      static_cast<std::streamsize>(journalBytes.size()));
+    journalFile.close();
+    if (!(journalFile.good())) {
+        return false;
+    }
+
+    // Make sure the entries are on disk before we report success. If we
+    // just created the journal, make its directory entry durable too.
+    if (!FileSync::syncFile(journalPath)) {
+        return false;
+    }
+    if (!journalExisted && !FileSync::syncDirectory(Paths::BASE_PATH)) {
+        return false;
+    }
+
+    bytesWritten = journalBytes.size();
+    return true;
+}
+
+bool TileMap::compactJournal(const SaveSnapshot& snapshot,
+                             std::size_t& bytesWritten) const
+{
+    std::string mapPath{Paths::BASE_PATH + MAP_FILE_NAME};
+    std::string tempMapPath{mapPath + ".tmp"};
+    std::string journalPath{Paths::BASE_PATH + JOURNAL_FILE_NAME};
+    std::string compactingJournalPath{Paths::BASE_PATH
+                                      + COMPACTING_JOURNAL_FILE_NAME};
+
+    // Write the snapshot to a temporary file.
+    if (!writeSnapshotToFile(snapshot, tempMapPath, bytesWritten)) {
+        return false;
+    }
 
-        // If we've processed all the chunks in this row, increment to the
-        // next row.
-        chunksProcessed++;
-        if (chunksProcessed == chunkExtent.xLength) {
-            startLinearTileIndex
-                += ((SharedConfig::CHUNK_WIDTH - 1) * tileExtent.xLength);
-            chunksProcessed = 0;
+    // Move the journal aside, replace the old map file, then delete the
+    // old journal.
+    // Note: Each of these steps is atomic. See recoverCompaction() for how
+    //       we handle crashing between them.
+    //       We sync the directory after each rename, so that they reach the
+    //       disk in this order.
+    std::error_code errorCode{};
+    if (std::filesystem::exists(journalPath, errorCode)) {
+        std::filesystem::rename(journalPath, compactingJournalPath,
+                                errorCode);
+        if (errorCode) {
+            LOG_ERROR("Failed to move journal: %s",
+                      errorCode.message().c_str());
+            return false;
+        }
+        if (!FileSync::syncDirectory(Paths::BASE_PATH)) {
+            return false;
         }
     }
 
-    // Serialize the map snapshot and write it to the file.
-    bool saveSuccessful{
-        Serialize::toFile((Paths::BASE_PATH + fileName), mapSnapshot)};
-    if (saveSuccessful) {
-        // Print the time taken.
-        double timeTaken{timer.getTime()};
-        LOG_INFO("Map saved in %.6fs.", timeTaken);
+    std::filesystem::rename(tempMapPath, mapPath, errorCode);
+    if (errorCode) {
+        LOG_ERROR("Failed to replace map file: %s",
+                  errorCode.message().c_str());
+        return false;
     }
-    else {
-        LOG_FATAL("Failed to serialize and save the map.");
+    if (!FileSync::syncDirectory(Paths::BASE_PATH)) {
+        return false;
     }
+
+    std::filesystem::remove(compactingJournalPath, errorCode);
+
+    return true;
 }
 
-void TileMap::load(TileMapSnapshot& mapSnapshot)
+void TileMap::setMapSize(unsigned int inMapXLengthChunks,
+                         unsigned int inMapYLengthChunks)
 {
-    /* Load the snapshot into this map. */
-    // Load the header data.
+    // Set our map size.
     // Note: We set x/y to 0 since our map origin is always (0, 0). Change
     //       this if we ever support negative origins.
     chunkExtent.x = 0;
     chunkExtent.y = 0;
-    chunkExtent.xLength = mapSnapshot.xLengthChunks;
-    chunkExtent.yLength = mapSnapshot.yLengthChunks;
+    chunkExtent.xLength = inMapXLengthChunks;
+    chunkExtent.yLength = inMapYLengthChunks;
     tileExtent.x = 0;
     tileExtent.y = 0;
     tileExtent.xLength = (chunkExtent.xLength * SharedConfig::CHUNK_WIDTH);
     tileExtent.yLength = (chunkExtent.yLength * SharedConfig::CHUNK_WIDTH);
 
-    // Resize the tiles vector to fit the map.
-    tiles.resize(tileExtent.xLength * tileExtent.yLength);
+    // Allocate the chunks that make up the map.
+    allocateChunks();
+}
+
+void TileMap::loadVersion0(const std::string& mapPath)
+{
+    // Deserialize the file into a snapshot.
+    TileMapSnapshot mapSnapshot;
+    if (!Deserialize::fromFile(mapPath, mapSnapshot)) {
+        LOG_FATAL("Failed to deserialize map at path: %s", mapPath.c_str());
+    }
+
+    setMapSize(mapSnapshot.xLengthChunks, mapSnapshot.yLengthChunks);
 
-    // Load the chunks into the tiles vector.
+    // Load the snapshot's chunks into our chunks.
     for (unsigned int chunkIndex = 0; chunkIndex < mapSnapshot.chunks.size();
          ++chunkIndex) {
-        // Calc the coordinates of this chunk's first tile.
-        unsigned int startX{(chunkIndex % chunkExtent.xLength)
-                            * SharedConfig::CHUNK_WIDTH};
-        unsigned int startY{(chunkIndex / chunkExtent.xLength)
-                            * SharedConfig::CHUNK_WIDTH};
-        ChunkSnapshot& chunk{mapSnapshot.chunks[chunkIndex]};
-
-        // These vars track which tile we're looking at, with respect to the
-        // top left of the chunk.
-        unsigned int relativeX{0};
-        unsigned int relativeY{0};
-
-        // Add all of this chunk's tiles to the tiles vector.
-        for (unsigned int i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
-            // Push all of the snapshot's sprites into the tile.
-            TileSnapshot& tileSnapshot{chunk.tiles[i]};
-            unsigned int layerIndex{0};
-            for (unsigned int paletteID : tileSnapshot.spriteLayers) {
-                const Sprite& sprite{spriteData.get(chunk.palette[paletteID])};
-                setTileSpriteLayer((startX + relativeX), (startY + relativeY),
-                                   layerIndex++, sprite);
+        ChunkPosition chunkPosition{
+            static_cast<int>(chunkIndex % chunkExtent.xLength),
+            static_cast<int>(chunkIndex / chunkExtent.xLength)};
+        ChunkSnapshot& chunkSnapshot{mapSnapshot.chunks[chunkIndex]};
+
+        // If this chunk has no sprites, leave it pointing at the empty
+        // sentinel.
+        if (chunkSnapshot.palette.size() == 0) {
+            continue;
+        }
+
+        loadChunk(chunkPosition, chunkSnapshot);
+
+        // Free the snapshot's copy of this chunk, so we don't hold the whole
+        // map twice while loading.
+        chunkSnapshot = {};
+    }
+}
+
+void TileMap::loadVersion1(const Uint8* fileData, std::size_t fileSize)
+{
+    // Load the header data.
+    if (fileSize < HEADER_SIZE) {
+        LOG_FATAL("Map file is truncated.");
+    }
+    Uint32 xLengthChunks{ByteTools::read32(&(fileData[2]))};
+    Uint32 yLengthChunks{ByteTools::read32(&(fileData[6]))};
+    Uint32 paletteCount{ByteTools::read32(&(fileData[10]))};
+    setMapSize(xLengthChunks, yLengthChunks);
+
+    // Resolve each palette entry to a numeric sprite ID.
+    std::vector<int> paletteIDs{};
+    paletteIDs.reserve(paletteCount);
+    std::size_t readIndex{HEADER_SIZE};
+    for (Uint32 i = 0; i < paletteCount; ++i) {
+        if ((readIndex + 1) > fileSize) {
+            LOG_FATAL("Map file is truncated.");
+        }
+        std::size_t idLength{fileData[readIndex++]};
+        if ((readIndex + idLength) > fileSize) {
+            LOG_FATAL("Map file is truncated.");
+        }
+
+        std::string stringID(
+            reinterpret_cast<const char*>(&(fileData[readIndex])), idLength);
+        paletteIDs.push_back(spriteData.get(stringID).numericID);
+        readIndex += idLength;
+    }
+
+    // Allocate each non-empty chunk, and gather the blocks to decode.
+    std::size_t chunkCount{chunkExtent.getCount()};
+    if ((readIndex + (chunkCount * CHUNK_TABLE_ENTRY_SIZE)) > fileSize) {
+        LOG_FATAL("Map file is truncated.");
+    }
+    std::vector<DecodeJob> decodeJobs{};
+    for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex) {
+        const Uint8* tableEntry{
+            &(fileData[readIndex + (chunkIndex * CHUNK_TABLE_ENTRY_SIZE)])};
+        std::size_t blockOffset{ByteTools::read32(tableEntry)};
+        std::size_t blockSize{ByteTools::read32(tableEntry + sizeof(Uint32))};
+        if (blockOffset == 0) {
+            continue;
+        }
+        else if ((blockOffset + blockSize) > fileSize) {
+            LOG_FATAL("Map file is truncated.");
+        }
+
+        ChunkPosition chunkPosition{
+            static_cast<int>(chunkIndex % chunkExtent.xLength),
+            static_cast<int>(chunkIndex / chunkExtent.xLength)};
+        decodeJobs.push_back({chunkPosition, &(fileData[blockOffset]),
+                              blockSize, &(getMutableChunk(chunkPosition))});
+    }
+
+    // Decode the chunks in parallel.
+    decodeChunks(decodeJobs, paletteIDs);
+}
+
+void TileMap::decodeChunks(const std::vector<DecodeJob>& decodeJobs,
+                           const std::vector<int>& paletteIDs)
+{
+    // Each thread claims the next job until they're all done.
+    // Note: Each job writes to a separate chunk (and its collision data), so
+    //       they don't need to be synchronized beyond this.
+    std::atomic<std::size_t> nextJobIndex{0};
+    auto decodeUntilDone = [&]() {
+        std::size_t jobIndex{0};
+        while ((jobIndex = nextJobIndex.fetch_add(1, std::memory_order_relaxed))
+               < decodeJobs.size()) {
+            const DecodeJob& decodeJob{decodeJobs[jobIndex]};
+            decodeChunk(decodeJob.chunkBlock, decodeJob.blockSize, paletteIDs,
+                        *(decodeJob.chunk));
+            rebuildChunkCollision(decodeJob.chunkPosition);
+        }
+    };
+
+    // Use as many threads as we have cores, as long as each has enough work
+    // to be worth starting.
+    std::size_t threadCount{std::max(std::thread::hardware_concurrency(), 1U)};
+    threadCount = std::min(threadCount, ((decodeJobs.size()
+                                          / MIN_CHUNKS_PER_LOAD_THREAD)
+                                         + 1));
+
+    // Start the extra threads, and help out on this one.
+    std::vector<std::thread> loadThreads{};
+    for (std::size_t i = 1; i < threadCount; ++i) {
+        loadThreads.emplace_back(decodeUntilDone);
+    }
+    decodeUntilDone();
+
+    for (std::thread& loadThread : loadThreads) {
+        loadThread.join();
+    }
+}
+
+void TileMap::decodeChunk(const Uint8* chunkBlock, std::size_t blockSize,
+                          const std::vector<int>& paletteIDs,
+                          Chunk& chunk) const
+{
+    // Decompress the chunk's data.
+    std::array<Uint8, MAX_CHUNK_DATA_SIZE> chunkData{};
+    std::size_t dataSize{ByteTools::decompress(chunkBlock, blockSize,
+                                               chunkData.data(),
+                                               chunkData.size())};
+
+    // Copy each tile's layers into the chunk.
+    std::size_t readIndex{0};
+    for (Tile& tile : chunk.tiles) {
+        if (readIndex >= dataSize) {
+            LOG_FATAL("Map chunk data is truncated.");
+        }
+        Uint8 layerCount{chunkData[readIndex++]};
+        if (layerCount > SharedConfig::MAX_TILE_LAYERS) {
+            LOG_FATAL("Tile has too many layers: %u", layerCount);
+        }
+        else if ((readIndex + (layerCount * sizeof(Uint16))) > dataSize) {
+            LOG_FATAL("Map chunk data is truncated.");
+        }
+
+        tile.layerCount = layerCount;
+        for (Uint8 i = 0; i < layerCount; ++i) {
+            Uint16 paletteIndex{ByteTools::read16(&(chunkData[readIndex]))};
+            readIndex += sizeof(Uint16);
+            if (paletteIndex >= paletteIDs.size()) {
+                LOG_FATAL("Invalid palette index: %u", paletteIndex);
             }
 
-            // Increment the relative indices, wrapping at the chunk width.
-            relativeX++;
-            if (relativeX == SharedConfig::CHUNK_WIDTH) {
-                relativeY++;
-                relativeX = 0;
+            tile.spriteIDs[i] = paletteIDs[paletteIndex];
+        }
+    }
+}
+
+std::size_t
+    TileMap::encodeChunk(const Chunk& chunk, Uint8* chunkData,
+                         std::unordered_map<int, Uint16>& paletteIndices,
+                         std::vector<int>& palette) const
+{
+    std::size_t writeIndex{0};
+    for (const Tile& tile : chunk.tiles) {
+        chunkData[writeIndex++] = tile.layerCount;
+        for (Uint8 i = 0; i < tile.layerCount; ++i) {
+            // Get the sprite's palette index, adding it if necessary.
+            auto [iterator, didEmplace] = paletteIndices.try_emplace(
+                tile.spriteIDs[i], static_cast<Uint16>(palette.size()));
+            if (didEmplace) {
+                palette.push_back(tile.spriteIDs[i]);
             }
+
+            ByteTools::write16(iterator->second, &(chunkData[writeIndex]));
+            writeIndex += sizeof(Uint16);
         }
     }
+
+    return writeIndex;
+}
+
+void TileMap::loadChunk(const ChunkPosition& chunkPosition,
+                        const ChunkSnapshot& chunkSnapshot)
+{
+    // If the snapshot has no sprites, release the chunk.
+    if (chunkSnapshot.palette.size() == 0) {
+        releaseChunk(chunkPosition);
+        return;
+    }
+
+    // Clear the chunk.
+    Chunk& chunk{getMutableChunk(chunkPosition)};
+    chunk = {};
+
+    // Copy all of the snapshot's sprites into the chunk's tiles.
+    for (unsigned int i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
+        const TileSnapshot& tileSnapshot{chunkSnapshot.tiles[i]};
+        if (tileSnapshot.spriteLayers.size() > SharedConfig::MAX_TILE_LAYERS) {
+            LOG_FATAL("Tile has too many layers: %u",
+                      tileSnapshot.spriteLayers.size());
+        }
+
+        Tile& tile{chunk.tiles[i]};
+        for (unsigned int paletteID : tileSnapshot.spriteLayers) {
+            tile.spriteIDs[tile.layerCount++]
+                = spriteData.get(chunkSnapshot.palette[paletteID]).numericID;
+        }
+    }
+
+    rebuildChunkCollision(chunkPosition);
+}
+
+void TileMap::saveChunk(const Chunk& chunk, ChunkSnapshot& chunkSnapshot) const
+{
+    // Process each tile in this chunk.
+    for (unsigned int i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
+        // Copy all of the tile's layers into the snapshot.
+        TileSnapshot& tileSnapshot{chunkSnapshot.tiles[i]};
+        const Tile& tile{chunk.tiles[i]};
+        for (std::size_t j = 0; j < tile.layerCount; ++j) {
+            const std::string& stringID{
+                spriteData.getStringID(tile.spriteIDs[j])};
+            unsigned int paletteID{chunkSnapshot.getPaletteIndex(stringID)};
+            tileSnapshot.spriteLayers.push_back(paletteID);
+        }
+    }
+}
+
+bool TileMap::writeSnapshotToFile(const SaveSnapshot& snapshot,
+                                  const std::string& filePath,
+                                  std::size_t& bytesWritten) const
+{
+    /* Encode and compress each non-empty chunk. */
+    std::size_t chunkCount{snapshot.chunks.size()};
+    std::unordered_map<int, Uint16> paletteIndices{};
+    std::vector<int> palette{};
+    std::vector<Uint8> chunkBlocks{};
+    std::vector<std::size_t> blockOffsets(chunkCount, 0);
+    std::vector<std::size_t> blockSizes(chunkCount, 0);
+    std::array<Uint8, MAX_CHUNK_DATA_SIZE> chunkData{};
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        // If this chunk was never allocated, leave it out.
+        if (snapshot.chunks[i] == emptyChunk) {
+            continue;
+        }
+
+        std::size_t dataSize{encodeChunk(*(snapshot.chunks[i]),
+                                         chunkData.data(), paletteIndices,
+                                         palette)};
+
+        std::size_t blockStart{chunkBlocks.size()};
+        std::size_t maxBlockSize{ByteTools::compressBound(dataSize)};
+        chunkBlocks.resize(blockStart + maxBlockSize);
+        std::size_t blockSize{ByteTools::compress(chunkData.data(), dataSize,
+                                                  &(chunkBlocks[blockStart]),
+                                                  maxBlockSize)};
+        chunkBlocks.resize(blockStart + blockSize);
+
+        blockOffsets[i] = blockStart;
+        blockSizes[i] = blockSize;
+    }
+
+    // Note: Palette indices are 16-bit.
+    if (palette.size() > (static_cast<std::size_t>(UINT16_MAX) + 1)) {
+        LOG_ERROR("Map uses too many unique sprites: %u", palette.size());
+        return false;
+    }
+
+    /* Build the palette, chunk table, and header. */
+    std::vector<Uint8> paletteBytes{};
+    for (int numericID : palette) {
+        const std::string& stringID{spriteData.getStringID(numericID)};
+        if (stringID.size() > UINT8_MAX) {
+            LOG_ERROR("Sprite ID is too long: %s", stringID.c_str());
+            return false;
+        }
+
+        paletteBytes.push_back(static_cast<Uint8>(stringID.size()));
+        paletteBytes.insert(paletteBytes.end(), stringID.begin(),
+                            stringID.end());
+    }
+
+    std::size_t blocksStart{HEADER_SIZE + paletteBytes.size()
+                            + (chunkCount * CHUNK_TABLE_ENTRY_SIZE)};
+    if ((blocksStart + chunkBlocks.size()) > UINT32_MAX) {
+        LOG_ERROR("Map is too large to save.");
+        return false;
+    }
+
+    std::vector<Uint8> chunkTable(chunkCount * CHUNK_TABLE_ENTRY_SIZE, 0);
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        if (blockSizes[i] > 0) {
+            Uint8* tableEntry{&(chunkTable[i * CHUNK_TABLE_ENTRY_SIZE])};
+            ByteTools::write32(static_cast<Uint32>(blocksStart
+                                                   + blockOffsets[i]),
+                               tableEntry);
+            ByteTools::write32(static_cast<Uint32>(blockSizes[i]),
+                               (tableEntry + sizeof(Uint32)));
+        }
+    }
+
+    std::array<Uint8, HEADER_SIZE> header{};
+    ByteTools::write16(MAP_FORMAT_VERSION, &(header[0]));
+    ByteTools::write32(static_cast<Uint32>(snapshot.chunkExtent.xLength),
+                       &(header[2]));
+    ByteTools::write32(static_cast<Uint32>(snapshot.chunkExtent.yLength),
+                       &(header[6]));
+    ByteTools::write32(static_cast<Uint32>(palette.size()), &(header[10]));
+
+    /* Write everything to the file. */
+    std::ofstream file(filePath, std::ios::binary);
+    if (!(file.is_open())) {
+        LOG_ERROR("Failed to open file: %s", filePath.c_str());
+        return false;
+    }
+    auto writeBytes = [&file](const std::vector<Uint8>& bytes) {
+        file.write(reinterpret_cast<const char*>(bytes.data()),
+                   static_cast<std::streamsize>(bytes.size()));
+    };
+    file.write(reinterpret_cast<const char*>(header.data()), HEADER_SIZE);
+    writeBytes(paletteBytes);
+    writeBytes(chunkTable);
+    writeBytes(chunkBlocks);
+    file.close();
+    if (!(file.good())) {
+        return false;
+    }
+
+    // Make sure the data is on disk before the caller renames the file into
+    // place. Otherwise, a crash could leave us with a renamed, empty file.
+    if (!FileSync::syncFile(filePath)) {
+        return false;
+    }
+
+    bytesWritten = (blocksStart + chunkBlocks.size());
+    return true;
+}
+
+void TileMap::recoverCompaction()
+{
+    std::string mapPath{Paths::BASE_PATH + MAP_FILE_NAME};
+    std::string tempMapPath{mapPath + ".tmp"};
+    std::string compactingJournalPath{Paths::BASE_PATH
+                                      + COMPACTING_JOURNAL_FILE_NAME};
+
+    std::error_code errorCode{};
+    bool tempMapExists{std::filesystem::exists(tempMapPath, errorCode)};
+    bool compactingJournalExists{
+        std::filesystem::exists(compactingJournalPath, errorCode)};
+
+    // If the journal was moved aside, the new map file was fully written
+    // before we crashed. Finish replacing the old one.
+    if (compactingJournalExists) {
+        LOG_INFO("Finishing interrupted map journal compaction.");
+        if (tempMapExists) {
+            std::filesystem::rename(tempMapPath, mapPath, errorCode);
+            if (errorCode) {
+                LOG_FATAL("Failed to replace map file: %s",
+                          errorCode.message().c_str());
+            }
+        }
+        std::filesystem::remove(compactingJournalPath, errorCode);
+    }
+    // Else if there's only a temp file, it may be partially written. The
+    // journal is still intact, so we can discard it.
+    else if (tempMapExists) {
+        std::filesystem::remove(tempMapPath, errorCode);
+    }
+}
+
+void TileMap::replayJournal()
+{
+    // If there's no journal, there's nothing to replay.
+    std::string journalPath{Paths::BASE_PATH + JOURNAL_FILE_NAME};
+    std::ifstream journalFile(journalPath, std::ios::binary);
+    if (!(journalFile.is_open())) {
+        return;
+    }
+
+    // Read the whole journal.
+    std::vector<Uint8> journalBytes{std::istreambuf_iterator<char>(journalFile),
+                                    std::istreambuf_iterator<char>()};
+
+    // Apply each entry, in order.
+    std::size_t entryCount{0};
+    std::size_t readIndex{0};
+    while ((readIndex + sizeof(Uint32)) <= journalBytes.size()) {
+        std::size_t entrySize{ByteTools::read32(&(journalBytes[readIndex]))};
+        readIndex += sizeof(Uint32);
+
+        // If the entry was only partially written (we crashed while
+        // appending it), stop.
+        if ((readIndex + entrySize) > journalBytes.size()) {
+            LOG_INFO("Ignoring truncated map journal entry.");
+            break;
+        }
+
+        MapJournalEntry journalEntry{};
+        if (!(Deserialize::fromBuffer(journalBytes.data(), entrySize,
+                                      journalEntry, readIndex))) {
+            LOG_ERROR("Failed to deserialize map journal entry.");
+            break;
+        }
+        readIndex += entrySize;
+
+        ChunkPosition chunkPosition{journalEntry.chunkX, journalEntry.chunkY};
+        if (!(chunkExtent.containsPosition(chunkPosition))) {
+            LOG_ERROR("Map journal entry is out of bounds: (%d, %d)",
+                      chunkPosition.x, chunkPosition.y);
+            continue;
+        }
+
+        loadChunk(chunkPosition, journalEntry.chunkSnapshot);
+        entryCount++;
+    }
+
+    if (entryCount > 0) {
+        LOG_INFO("Replayed %u chunks from the map journal.", entryCount);
+    }
 }
 
 } // End namespace Server
@@ -3,8 +3,10 @@
 #include "Network.h"
 #include "ISimulationExtension.h"
 #include "ClientSimData.h"
+#include "ChunkExtent.h"
 #include "AMAssert.h"
 #include "Tracy.hpp"
+#include <unordered_map>
 
 namespace AM
 {
@@ -13,10 +15,12 @@ namespace Server
 TileUpdateSystem::TileUpdateSystem(
     World& inWorld, EventDispatcher& inNetworkEventDispatcher,
     Network& inNetwork,
-    const std::unique_ptr<ISimulationExtension>& inExtension)
+    const std::unique_ptr<ISimulationExtension>& inExtension,
+    std::pmr::memory_resource& inTickArena)
 : world{inWorld}
 , network{inNetwork}
 , extension{inExtension}
+, tickArena{inTickArena}
 , tileUpdateRequestQueue(inNetworkEventDispatcher)
 {
 }
@@ -52,58 +56,89 @@ void TileUpdateSystem::updateTiles()
 
 void TileUpdateSystem::sendTileUpdates()
 {
-    auto clientView = world.registry.view<ClientSimData>();
+    ZoneScoped;
+
     std::unordered_map<TilePosition, std::size_t>& dirtyTiles{
         world.tileMap.getDirtyTiles()};
+    if (dirtyTiles.size() == 0) {
+        return;
+    }
 
-    // For every tile with dirty state, push it into the working update of
-    // each client in range.
+    // Group the dirty tiles by the chunk that they're in.
+    // Note: These are only needed for this tick, so they're allocated from
+    //       the tick arena.
+    std::pmr::unordered_map<ChunkPosition, std::pmr::vector<TilePosition>>
+        dirtyTilesByChunk{&tickArena};
     for (const auto& [tilePos, lowestDirtyLayerIndex] : dirtyTiles) {
-        // Calc how many layers the tile has, starting at the lowest dirty
-        // layer. Note: This tile might be fully cleared (no layers).
-        const Tile& tile{world.tileMap.getTile(tilePos.x, tilePos.y)};
-        std::size_t layerCount{tile.spriteLayers.size()
-                               - lowestDirtyLayerIndex};
-        AM_ASSERT(lowestDirtyLayerIndex <= SDL_MAX_UINT8,
-                  "Too large for Uint8.");
-        AM_ASSERT(layerCount <= SDL_MAX_UINT8, "Too large for Uint8.");
+        dirtyTilesByChunk[ChunkPosition{tilePos}].push_back(tilePos);
+    }
 
-        // Get the list of clients that are in range of this tile.
+    // For every chunk with dirty tiles, build an update message and send it
+    // to each client in range.
+    auto clientView = world.registry.view<ClientSimData>();
+    for (auto& [chunkPos, tilePositions] : dirtyTilesByChunk) {
+        // Get the list of entities that are in range of this chunk.
         // Note: This is hardcoded to match ChunkUpdateSystem.
-        ChunkPosition centerChunk{TilePosition{tilePos.x, tilePos.y}};
-        ChunkExtent chunkExtent{(centerChunk.x - 1), (centerChunk.y - 1), 3, 3};
+        ChunkExtent chunkExtent{(chunkPos.x - 1), (chunkPos.y - 1), 3, 3};
         chunkExtent.intersectWith(world.tileMap.getChunkExtent());
-
-        // Add this tile to the working update of all clients that are in range.
         std::vector<entt::entity>& entitiesInRange{
             world.entityLocator.getEntitiesFine(chunkExtent)};
+
+        // Build and serialize the update once, the first time we find a
+        // client that needs it.
+        BinaryBufferSharedPtr updateBuffer{nullptr};
         for (entt::entity entity : entitiesInRange) {
-            ClientSimData& client{clientView.get<ClientSimData>(entity)};
+            // Skip non-client entities.
+            if (!(clientView.contains(entity))) {
+                continue;
+            }
 
-            // Push the tile info.
-            workingUpdates[client.netID].tileInfo.emplace_back(
-                tilePos.x, tilePos.y, static_cast<Uint8>(layerCount),
-                static_cast<Uint8>(lowestDirtyLayerIndex));
-
-            // Push the numericID of the lowest updated layer and all layers
-            // above it.
-            for (std::size_t i = 0; i < layerCount; ++i) {
-                int numericID{tile.spriteLayers[lowestDirtyLayerIndex + i]
-                                  .sprite.numericID};
-                workingUpdates[client.netID].updatedLayers.push_back(numericID);
+            if (updateBuffer == nullptr) {
+                fillTileUpdate(tilePositions, workingUpdate);
+                updateBuffer = network.serialize(workingUpdate);
             }
-        }
-    }
 
-    // Send all the updates.
-    for (auto& [netID, tileUpdate] : workingUpdates) {
-        network.serializeAndSend<TileUpdate>(netID, tileUpdate);
+            ClientSimData& client{clientView.get<ClientSimData>(entity)};
+            network.send(client.netID, updateBuffer);
+        }
     }
-    workingUpdates.clear();
 
     // The dirty tile map state is now clean, clear the tracked dirty tiles.
     dirtyTiles.clear();
 }
 
+void TileUpdateSystem::fillTileUpdate(
+    const std::pmr::vector<TilePosition>& tilePositions,
+    TileUpdate& tileUpdate)
+{
+    tileUpdate.tileInfo.clear();
+    tileUpdate.updatedLayers.clear();
+
+    std::unordered_map<TilePosition, std::size_t>& dirtyTiles{
+        world.tileMap.getDirtyTiles()};
+    for (const TilePosition& tilePos : tilePositions) {
+        // Calc how many layers the tile has, starting at the lowest dirty
+        // layer. Note: This tile might be fully cleared (no layers).
+        std::size_t lowestDirtyLayerIndex{dirtyTiles[tilePos]};
+        const Tile& tile{world.tileMap.getTile(tilePos.x, tilePos.y)};
+        std::size_t layerCount{tile.layerCount - lowestDirtyLayerIndex};
+        AM_ASSERT(lowestDirtyLayerIndex <= SDL_MAX_UINT8,
+                  "Too large for Uint8.");
+        AM_ASSERT(layerCount <= SDL_MAX_UINT8, "Too large for Uint8.");
+
+        // Push the tile info.
+        tileUpdate.tileInfo.emplace_back(
+            tilePos.x, tilePos.y, static_cast<Uint8>(layerCount),
+            static_cast<Uint8>(lowestDirtyLayerIndex));
+
+        // Push the numericID of the lowest updated layer and all layers
+        // above it.
+        for (std::size_t i = 0; i < layerCount; ++i) {
+            tileUpdate.updatedLayers.push_back(
+                tile.spriteIDs[lowestDirtyLayerIndex + i]);
+        }
+    }
+}
+
 } // End namespace Server
 } // End namespace AM
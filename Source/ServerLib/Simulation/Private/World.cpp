@@ -2,6 +2,7 @@
 #include "ClientSimData.h"
 #include "SharedConfig.h"
 #include "Config.h"
+#include "IDPool.h"
 #include "Log.h"
 #include "Ignore.h"
 
@@ -13,6 +14,7 @@ World::World(SpriteData& spriteData)
 : registry()
 , tileMap(spriteData)
 , entityLocator(registry)
+, netIdMap(Config::MAX_CLIENTS + IDPool::SAFETY_BUFFER)
 , randomDevice()
 , generator(randomDevice())
 , xDistribution(Config::SPAWN_POINT_RANDOM_MIN_X,
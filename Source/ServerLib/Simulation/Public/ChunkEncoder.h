@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Chunk.h"
+#include "ChunkPosition.h"
+#include "BinaryBuffer.h"
+#include "readerwriterqueue.h"
+#include <SDL_stdinc.h>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+
+namespace AM
+{
+struct ChunkUpdate;
+
+namespace Server
+{
+class Network;
+
+/**
+ * Encodes chunks into serialized ChunkUpdate messages on a background
+ * thread.
+ *
+ * The sim thread pushes immutable chunk snapshots (see
+ * TileMapBase::getChunkSnapshot()) and later pops the finished messages, so
+ * it only needs to do constant-time bookkeeping per chunk.
+ *
+ * Note: pushJob() and popResult() must only be called from a single thread.
+ */
+class ChunkEncoder
+{
+public:
+    /**
+     * A chunk that needs to be encoded.
+     */
+    struct EncodeJob {
+        /** The position of the chunk. */
+        ChunkPosition position{};
+
+        /** The version of the chunk that the snapshot was taken from. */
+        Uint32 version{0};
+
+        /** The chunk's tile data. */
+        std::shared_ptr<const Chunk> chunk{nullptr};
+    };
+
+    /**
+     * A chunk that has finished being encoded.
+     */
+    struct EncodedChunk {
+        /** The position of the chunk. */
+        ChunkPosition position{};
+
+        /** The version of the chunk that the message was built from. */
+        Uint32 version{0};
+
+        /** The serialized ChunkUpdate message, containing only this chunk. */
+        BinaryBufferSharedPtr message{nullptr};
+    };
+
+    ChunkEncoder(Network& inNetwork);
+
+    ~ChunkEncoder();
+
+    /**
+     * Queues the given chunk to be encoded.
+     */
+    void pushJob(EncodeJob&& encodeJob);
+
+    /**
+     * If a chunk has finished being encoded, moves it into the given
+     * struct.
+     *
+     * @return true if a chunk was popped, else false.
+     */
+    bool popResult(EncodedChunk& encodedChunk);
+
+private:
+    /** How long the encode thread will wait for a job before checking if it
+        should exit. */
+    static constexpr std::int64_t JOB_WAIT_TIMEOUT_US{100'000};
+
+    /**
+     * Thread function, started from constructor.
+     *
+     * Waits for jobs, encodes them, and pushes the results.
+     */
+    void encodeChunks();
+
+    /**
+     * Adds the given chunk to the given ChunkUpdate message.
+     */
+    void addChunkToMessage(const EncodeJob& encodeJob,
+                           ChunkUpdate& chunkUpdate);
+
+    /** Used for serializing messages. */
+    Network& network;
+
+    /** Chunks waiting to be encoded. */
+    moodycamel::BlockingReaderWriterQueue<EncodeJob> jobQueue;
+
+    /** Chunks that have finished being encoded. */
+    moodycamel::ReaderWriterQueue<EncodedChunk> resultQueue;
+
+    /** Maps numeric sprite IDs to their index in the palette of the chunk
+        that's being encoded. Only used by the encode thread. */
+    std::unordered_map<int, unsigned int> paletteIndices;
+
+    /** Calls encodeChunks(). */
+    std::thread encodeThreadObj;
+
+    /** Turn true to signal that the encode thread should end. */
+    std::atomic<bool> exitRequested;
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -4,11 +4,15 @@
 #include "QueuedEvents.h"
 #include "ChunkUpdateRequest.h"
 #include "ChunkPosition.h"
+#include "BinaryBuffer.h"
+#include "ChunkEncoder.h"
+#include <SDL_stdinc.h>
+#include <unordered_map>
+#include <list>
+#include <vector>
 
 namespace AM
 {
-struct ChunkUpdate;
-
 namespace Server
 {
 class World;
@@ -20,6 +24,16 @@ class Network;
  * A client may require chunks to be sent when it logs in, moves into a new
  * chunk, or teleports.
  *
+ * Requested chunks are queued per-client and streamed over multiple ticks,
+ * closest to the client first. The number of bytes that we send per tick is
+ * limited, both overall and per-client (see Config::CHUNK_STREAMING_*).
+ *
+ * Each chunk is sent as its own ChunkUpdate message. Messages are encoded
+ * on a background thread (see ChunkEncoder), then cached per-chunk and
+ * re-used until the chunk's version changes, so repeated requests for the
+ * same chunk don't need to rebuild it. Chunks that are still being encoded
+ * stay queued until their message is ready.
+ *
  * Note: We have no validation to see if client entities are in range of the
  *       requested chunks, but the worlds are all open source so it doesn't
  *       matter anyway. If someone wants to see the map, they can already get
@@ -33,31 +47,116 @@ public:
                          Network& inNetwork);
 
     /**
-     * Processes chunk update requests, sending chunk data if the request is
-     * valid.
+     * Processes chunk update requests, queueing the requested chunks if the
+     * request is valid.
+     * Sends as many queued chunks as fit in this tick's budget.
      */
     void sendChunks();
 
 private:
     /**
-     * Send a chunk update, containing the chunks from the given request.
+     * The chunks that a particular client is waiting to be sent.
      */
-    void sendChunkUpdate(const ChunkUpdateRequest& chunkUpdateRequest);
+    struct ClientChunkQueue {
+        /** The client that requested the chunks. */
+        NetworkID netID{0};
+
+        /** The generation of netID's slot in World::netIdMap when this queue
+            was created. If it changes, the client disconnected and the ID
+            was reused. */
+        Uint32 generation{0};
+
+        /** The chunks that still need to be sent. */
+        std::vector<ChunkPosition> chunks{};
+    };
 
     /**
-     * Adds the given chunk to the given UpdateChunks message.
+     * Adds the chunks from the given request to the requesting client's
+     * queue.
+     */
+    void queueRequestedChunks(const ChunkUpdateRequest& chunkUpdateRequest);
+
+    /**
+     * Sends queued chunks to each client, until this tick's budget is spent.
+     * Clients are served round-robin, starting where we left off last tick.
+     */
+    void sendQueuedChunks();
+
+    /**
+     * Sends the given client's closest queued chunks, up to its per-tick
+     * budget.
      *
-     * @param chunkPosition  The position of the chunk to add.
-     * @param chunkUpdate  The message struct to add the chunk to.
+     * @param bytesRemaining  The number of bytes left in this tick's overall
+     *                        budget.
+     * @return The number of bytes that were sent.
+     */
+    std::size_t sendClientChunks(ClientChunkQueue& clientQueue,
+                                 std::size_t bytesRemaining);
+
+    /**
+     * Moves any chunks that the encoder has finished into chunkCache.
      */
-    void addChunkToMessage(const ChunkPosition& chunkPosition,
-                           ChunkUpdate& chunkUpdate);
+    void receiveEncodedChunks();
+
+    /**
+     * Returns a serialized ChunkUpdate message containing the given chunk.
+     *
+     * If the chunk has changed since the message was last built (or it was
+     * never built), queues it to be encoded and returns nullptr.
+     */
+    BinaryBufferSharedPtr getChunkMessage(const ChunkPosition& chunkPosition);
+
+    /**
+     * A serialized ChunkUpdate message containing a single chunk.
+     */
+    struct CachedChunk {
+        /** The version of the chunk that message was built from. */
+        Uint32 version{0};
+
+        /** The serialized message, ready to be sent. */
+        BinaryBufferSharedPtr message{nullptr};
+
+        /** If true, this chunk has been pushed to the encoder and we're
+            waiting for the result. */
+        bool isEncoding{false};
+
+        /** If isEncoding, this is the version of the chunk that we're
+            waiting on. */
+        Uint32 encodingVersion{0};
+
+        /** This chunk's position in cacheRecency. */
+        std::list<ChunkPosition>::iterator recencyIt{};
+    };
+
+    /**
+     * Returns the given chunk's cache entry, adding one if it doesn't have
+     * one, and marks it as the most recently used.
+     * If the cache is full, evicts the least recently used entry first.
+     */
+    CachedChunk& touchCachedChunk(const ChunkPosition& chunkPosition);
 
     /** Used for fetching entity, component, and map data. */
     World& world;
     /** Used for sending chunks to clients. */
     Network& network;
 
+    /** Holds the serialized messages for recently requested chunks.
+        Bounded by Config::CHUNK_CACHE_MAX_CHUNKS. */
+    std::unordered_map<ChunkPosition, CachedChunk> chunkCache;
+
+    /** The positions of the chunks in chunkCache, from most to least
+        recently used. */
+    std::list<ChunkPosition> cacheRecency;
+
+    /** Encodes chunk messages on a background thread. */
+    ChunkEncoder chunkEncoder;
+
+    /** The chunks that each client is waiting to be sent. */
+    std::vector<ClientChunkQueue> clientQueues;
+
+    /** The index in clientQueues of the client to serve first next tick. */
+    std::size_t nextClientIndex;
+
     EventQueue<ChunkUpdateRequest> chunkUpdateRequestQueue;
 };
 
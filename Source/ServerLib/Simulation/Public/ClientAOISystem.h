@@ -2,14 +2,18 @@
 
 #include "entt/fwd.hpp"
 #include <vector>
+#include <cstddef>
 
 namespace AM
 {
+struct Position;
+
 namespace Server
 {
 class Simulation;
 class World;
 class Network;
+class SimRegions;
 struct ClientSimData;
 
 /**
@@ -22,6 +26,10 @@ struct ClientSimData;
  * When a peer leaves a client entity's AOI, this system will update the lists
  * appropriately and send an EntityDelete message to the client.
  *
+ * Each region's clients are processed on that region's worker (see
+ * SimRegions). Since AOI queries go through the shared entity locator, a
+ * client near a region border still sees the entities on the other side.
+ *
  * Note: The AOI lists also must be updated when an entity disconnects. Since
  *       it's easiest to do this while the entity is still alive, and
  *       ClientConnectionSystem maintains the lifetime of client entities, it's
@@ -31,7 +39,7 @@ class ClientAOISystem
 {
 public:
     ClientAOISystem(Simulation& inSimulation, World& inWorld,
-                    Network& inNetwork);
+                    Network& inNetwork, SimRegions& inSimRegions);
 
     /**
      * Updates the peersInAOI list in any client entities that have recently
@@ -43,11 +51,37 @@ public:
     void updateAOILists();
 
 private:
+    /**
+     * Scratch data for a single region. Kept between ticks so its
+     * allocations are re-used.
+     */
+    struct RegionScratch {
+        /** Holds the entities that are currently in a client's AOI. */
+        std::vector<entt::entity> currentAOIEntities;
+
+        /** Holds entities that left a client's AOI. */
+        std::vector<entt::entity> entitiesThatLeft;
+    };
+
+    /**
+     * Updates the given client entity's AOI list, sending messages for any
+     * entities that entered or left it.
+     *
+     * Note: This may run on a worker thread. It only modifies the given
+     *       client, and only reads everything else.
+     *
+     * @param scratch  The scratch data of the region that owns the client.
+     */
+    void updateClientAOI(entt::entity entity, ClientSimData& client,
+                         const Position& position, RegionScratch& scratch);
+
     /**
      * Sends an EntityDelete message to the given client for each entity that
      * left its AOI.
      */
-    void processEntitiesThatLeft(ClientSimData& client);
+    void processEntitiesThatLeft(
+        ClientSimData& client,
+        const std::vector<entt::entity>& entitiesThatLeft);
 
     /**
      * Sends an EntityInit message to the given client for each entity that
@@ -61,9 +95,11 @@ private:
     World& world;
     /** Used for sending messages. */
     Network& network;
+    /** Used to get each region's clients and run the region jobs. */
+    SimRegions& simRegions;
 
-    /** Holds entities that left the AOI. Used during updateAOILists(). */
-    std::vector<entt::entity> entitiesThatLeft;
+    /** Each region's scratch data, indexed by region. */
+    std::vector<RegionScratch> regionScratch;
 };
 
 } // End namespace Server
@@ -3,7 +3,9 @@
 #include "NetworkDefs.h"
 #include "ServerNetworkDefs.h"
 #include "QueuedEvents.h"
+#include "Config.h"
 #include "entt/fwd.hpp"
+#include <deque>
 
 namespace AM
 {
@@ -17,6 +19,10 @@ class SpriteData;
 /**
  * This system is in charge of processing client connect/disconnect events and
  * updating the client's entity.
+ *
+ * Newly connected clients are put in a join queue, and at most
+ * Config::MAX_JOINS_PER_TICK of them are spawned each tick. While waiting,
+ * clients are periodically sent their position in the queue.
  */
 class ClientConnectionSystem
 {
@@ -32,11 +38,46 @@ public:
     void processConnectionEvents();
 
 private:
+    /** How often clients in the join queue are sent their position. */
+    static constexpr Uint32 JOIN_QUEUE_UPDATE_TICKS{static_cast<Uint32>(
+        Config::JOIN_QUEUE_UPDATE_PERIOD_S
+        * SharedConfig::SIM_TICKS_PER_SECOND)};
+
+    /** How often join latency stats are logged. */
+    static constexpr Uint32 JOIN_STATS_REPORT_TICKS{static_cast<Uint32>(
+        Config::JOIN_STATS_REPORT_PERIOD_S
+        * SharedConfig::SIM_TICKS_PER_SECOND)};
+
+    /** A newly connected client that's waiting to be spawned. */
+    struct PendingJoin {
+        NetworkID clientID{0};
+
+        /** The tick that the client's connection was received on. */
+        Uint32 connectedTick{0};
+    };
+
     /**
-     * Processes all newly connected clients, adding them to the sim.
+     * Adds all newly connected clients to the join queue, spawns as many
+     * as are allowed this tick, and updates the rest on their position.
      */
     void processConnectEvents();
 
+    /**
+     * Builds the given client's entity and sends them a connection response.
+     */
+    void spawnClient(const PendingJoin& pendingJoin);
+
+    /**
+     * Sends join queue positions to the last updateCount clients in the
+     * queue.
+     */
+    void sendQueuePositions(std::size_t updateCount);
+
+    /**
+     * Logs the join latency stats if it's time to, and resets them.
+     */
+    void reportJoinStats();
+
     /**
      * Processes all newly disconnected clients, removing them from the sim.
      */
@@ -65,6 +106,16 @@ private:
 
     EventQueue<ClientConnected> clientConnectedQueue;
     EventQueue<ClientDisconnected> clientDisconnectedQueue;
+
+    /** Clients that have connected but haven't been spawned yet, in the order
+        that they connected. */
+    std::deque<PendingJoin> joinQueue;
+
+    /** Join latency stats, since the last report. */
+    unsigned int joinCount;
+    Uint64 totalJoinWaitTicks;
+    Uint32 maxJoinWaitTicks;
+    std::size_t maxJoinQueueLength;
 };
 
 } // End namespace Server
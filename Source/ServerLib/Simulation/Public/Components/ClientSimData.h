@@ -2,6 +2,8 @@
 
 #include "NetworkDefs.h"
 #include "entt/fwd.hpp"
+#include "entt/entity/entity.hpp"
+#include <SDL_stdinc.h>
 #include <vector>
 
 namespace AM
@@ -19,6 +21,22 @@ namespace Server
  */
 struct ClientSimData {
 public:
+    /**
+     * An entity whose movement state needs to be sent to this client, but
+     * hasn't been yet.
+     */
+    struct PendingSync {
+        /** The entity that needs to be synced. */
+        entt::entity entity{entt::null};
+
+        /** The tick that this entity started waiting to be synced on. */
+        Uint32 sinceTick{0};
+
+        /** If true, this entity just entered the client's AOI and the client
+            hasn't received any movement state for it yet. */
+        bool isInitial{false};
+    };
+
     /** The network ID associated with this client.
         We track this here so the sim knows where to send messages related to
         the entity.
@@ -33,6 +51,12 @@ public:
         tick.
         Only valid after ClientAOISystem has ran. */
     std::vector<entt::entity> entitiesThatEnteredAOI{};
+
+    /** Tracks the entities in this client's AOI that need their movement
+        state synced, but were deferred by MovementSyncSystem (because
+        they're far away, or the client's bandwidth budget was spent).
+        Kept sorted by entity, so it can be merged with entitiesInAOI. */
+    std::vector<PendingSync> pendingMovementSyncs{};
 };
 
 } // namespace Server
@@ -6,8 +6,13 @@
 #include "Velocity.h"
 #include "Rotation.h"
 #include "Collision.h"
+#include "ClientSimData.h"
+#include "Name.h"
+#include "Sprite.h"
+#include "MovementStateNeedsSync.h"
 #include "Ignore.h"
 #include "entt/entity/registry.hpp"
+#include <utility>
 
 namespace AM
 {
@@ -16,6 +21,11 @@ namespace Server
 class EnttGroups
 {
 public:
+    /** The group that's used for moving an entity. */
+    using MovementGroup = decltype(std::declval<entt::registry&>()
+                                       .group<Input, Position, PreviousPosition,
+                                              Velocity, Rotation, Collision>());
+
     /**
      * Initializes the entt groups that this module uses.
      *
@@ -29,9 +39,18 @@ public:
     static void init(entt::registry& registry)
     {
         // Used for moving an entity.
-        auto movementGroup = registry.group<Input, Position, PreviousPosition,
-                                            Velocity, Rotation, Collision>();
+        MovementGroup movementGroup{
+            registry.group<Input, Position, PreviousPosition, Velocity,
+                           Rotation, Collision>()};
         ignore(movementGroup);
+
+        // Create the storage for the components that region jobs read (see
+        // SimRegions). Storage is created on first use, which modifies the
+        // registry, so it can't be left to the worker threads.
+        auto regionJobView{
+            registry.view<ClientSimData, Name, Sprite,
+                          MovementStateNeedsSync>()};
+        ignore(regionJobView);
     }
 };
 
@@ -1,9 +1,6 @@
 #pragma once
 
-#include "NetworkDefs.h"
-#include "QueuedEvents.h"
-#include "InputChangeRequest.h"
-#include "EventSorter.h"
+#include "entt/fwd.hpp"
 
 namespace AM
 {
@@ -11,7 +8,7 @@ namespace Server
 {
 class Simulation;
 class World;
-class Network;
+class ClientInputRings;
 
 /**
  * Receives input messages from clients and applies them to the client's
@@ -21,32 +18,33 @@ class InputSystem
 {
 public:
     InputSystem(Simulation& inSimulation, World& inWorld,
-                EventDispatcher& inNetworkEventDispatcher);
+                ClientInputRings& inClientInputRings);
 
     /**
-     * Processes incoming InputChangeRequest messages.
+     * Applies each client's input for the current tick, if they sent one.
      */
     void processInputMessages();
 
 private:
     /**
-     * Processes message drop events, which occur when the server received a
-     * client's input message late and had to drop it.
+     * Handles a dropped input, which occurs when the server received a
+     * client's input message too late (or too early) and had to drop it.
      *
      * We default the client's inputs (so they don't run off a cliff) and set
      * a flag so the NetworkUpdateSystem knows that a drop occurred.
      *
-     * @param clientID  The ID of the client that we had to drop a message from.
+     * @param clientEntity  The entity of the client that we had to drop a
+     *                      message from.
      */
-    void handleDroppedMessage(NetworkID clientID);
+    void handleDroppedMessage(entt::entity clientEntity);
 
     /** Used to get the current tick. */
     Simulation& simulation;
     /** Used to access components. */
     World& world;
 
-    EventQueue<InputChangeRequest> inputChangeRequestQueue;
-    EventSorter<InputChangeRequest> inputChangeRequestSorter;
+    /** Holds each client's received inputs, indexed by tick. */
+    ClientInputRings& clientInputRings;
 };
 
 } // namespace Server
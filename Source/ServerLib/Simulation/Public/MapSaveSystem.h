@@ -1,6 +1,13 @@
 #pragma once
 
+#include "TileMap.h"
 #include "Timer.h"
+#include "readerwriterqueue.h"
+#include <SDL_stdinc.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
 
 namespace AM
 {
@@ -10,25 +17,151 @@ namespace Server
 class World;
 
 /**
- * Periodically saves the world's tile map to TileMap.bin.
+ * Persists the world's tile map.
+ *
+ * Chunks that changed are periodically appended to the map's journal.
+ * Less often, the whole map is saved to TileMap.bin and the journal is
+ * cleared (see TileMap::compactJournal()).
+ *
+ * To avoid stalling the sim, we only take copy-on-write snapshots of the
+ * map on the sim thread. The snapshots are encoded and written to disk on a
+ * background thread.
  */
 class MapSaveSystem
 {
 public:
     MapSaveSystem(World& inWorld);
 
+    ~MapSaveSystem();
+
     /**
-     * If enough time has passed, saves the tile map.
+     * If enough time has passed, starts journaling or saving the tile map.
+     * Also logs the results of any finished saves.
      *
-     * Configure through Config::MAP_SAVE_PERIOD.
+     * Configure through Config::MAP_SAVE_PERIOD_S and
+     * Config::MAP_JOURNAL_PERIOD_S. Does nothing if the map's saving is
+     * disabled (see TileMap::setSavingEnabled()).
      */
     void saveMapIfNecessary();
 
 private:
+    /**
+     * A snapshot that needs to be written.
+     */
+    struct SaveJob {
+        /** If true, this is a full save. Else, it's a journal append. */
+        bool isFullSave{false};
+
+        /** If isFullSave, the snapshot to save. */
+        TileMap::SaveSnapshot saveSnapshot{};
+
+        /** If !isFullSave, the chunks to append. */
+        TileMap::JournalSnapshot journalSnapshot{};
+
+        /** The positions of the chunks that this job will save. */
+        std::vector<ChunkPosition> chunkPositions{};
+
+        /** The version of each chunk in chunkPositions, as of when it was
+            snapshotted. */
+        std::vector<Uint32> chunkVersions{};
+    };
+
+    /**
+     * The results of a finished save job.
+     */
+    struct SaveResult {
+        /** If true, this was a full save. Else, it was a journal append. */
+        bool isFullSave{false};
+
+        /** If true, the data was successfully written. */
+        bool wasSuccessful{false};
+
+        /** How long it took to encode and write the data, in seconds. */
+        double saveTimeS{0};
+
+        /** The number of bytes that were written. */
+        std::size_t bytesWritten{0};
+
+        /** The job's chunkPositions. */
+        std::vector<ChunkPosition> chunkPositions{};
+
+        /** The job's chunkVersions. */
+        std::vector<Uint32> chunkVersions{};
+    };
+
+    /** How long the save thread will wait for a job before checking if it
+        should exit. */
+    static constexpr std::int64_t JOB_WAIT_TIMEOUT_US{100'000};
+
+    /**
+     * Snapshots the whole map and pushes it to the save thread.
+     */
+    void startFullSave();
+
+    /**
+     * Snapshots any chunks that changed since they were last saved and
+     * pushes them to the save thread.
+     */
+    void startJournalAppend();
+
+    /**
+     * Thread function, started from constructor.
+     *
+     * Waits for jobs, saves them, and pushes the results.
+     */
+    void saveSnapshots();
+
+    /**
+     * Logs the results of any finished saves.
+     * If a save succeeded, commits its chunks to savedChunkVersions. If it
+     * failed, marks its chunks as unsaved so they'll be journaled again.
+     */
+    void receiveSaveResults();
+
+    /**
+     * Returns the index in our chunk version vectors of the given chunk.
+     */
+    std::size_t getChunkIndex(const ChunkPosition& chunkPosition) const;
+
     World& world;
 
-    /** Used to track how much time has passed since the last save. */
+    /** Used to track how much time has passed since the last full save. */
     Timer saveTimer;
+
+    /** Used to track how much time has passed since the last journal
+        append. */
+    Timer journalTimer;
+
+    /** The version of each chunk, as of the last time it was successfully
+        saved or journaled. */
+    std::vector<Uint32> savedChunkVersions;
+
+    /** The version of each chunk, as of the last time it was pushed to the
+        save thread. Used to find the chunks that changed, so that chunks
+        aren't pushed again while they're still being written.
+        If a write fails, its chunks are reset to their savedChunkVersions
+        value. */
+    std::vector<Uint32> queuedChunkVersions;
+
+    /** If true, a full save has been pushed to the save thread and we're
+        waiting for the result. */
+    bool isSaving;
+
+    /** How long it took to take the current full save's snapshot, in
+        seconds. */
+    double snapshotTimeS;
+
+    /** Snapshots waiting to be saved. */
+    moodycamel::BlockingReaderWriterQueue<SaveJob> jobQueue;
+
+    /** The results of finished saves. */
+    moodycamel::ReaderWriterQueue<SaveResult> resultQueue;
+
+    /** Calls saveSnapshots(). */
+    std::thread saveThreadObj;
+
+    /** Turn true to signal that the save thread should end. */
+    std::atomic<bool> exitRequested;
 };
 
 } // namespace Server
@@ -1,6 +1,15 @@
 #pragma once
 
+#include "Config.h"
+#include "SharedConfig.h"
+#include "MovementUpdate.h"
+#include "ClientSimData.h"
 #include "entt/entity/registry.hpp"
+#include <SDL_stdinc.h>
+#include <algorithm>
+#include <vector>
+#include <memory_resource>
+#include <cstddef>
 
 namespace AM
 {
@@ -14,7 +23,7 @@ namespace Server
 class Simulation;
 class World;
 class Network;
-struct ClientSimData;
+class SimRegions;
 
 /**
  * Sends clients the movement state of any nearby entities that need to be
@@ -26,12 +35,26 @@ struct ClientSimData;
  *      (in such a case, we zero-out their input state so they don't run off
  *      a cliff).
  *   3. The entity was teleported.
+ *
+ * Replication is prioritized per-client:
+ *   The client's own entity, and entities that just entered the client's
+ *   AOI, are always sent immediately.
+ *   Other entities are sent at a rate based on their distance from the
+ *   client (see Config::MOVEMENT_SYNC_*_RADIUS). Far entities may wait a few
+ *   ticks before their new state is sent.
+ *   Each client has a byte budget per network tick. If more entities need
+ *   to be sent than fit in the budget, they're ranked by distance and
+ *   staleness and the rest are deferred to a later tick.
+ *
+ * Each region's clients are processed on that region's worker (see
+ * SimRegions). Entities in other regions are only read, so a client near a
+ * region border is still sent the state of its neighbors across it.
  */
 class MovementSyncSystem
 {
 public:
     MovementSyncSystem(Simulation& inSimulation, World& inWorld,
-                       Network& inNetwork);
+                       Network& inNetwork, SimRegions& inSimRegions);
 
     /**
      * Updates all connected clients with relevant entity movement state.
@@ -39,21 +62,102 @@ public:
     void sendMovementUpdates();
 
 private:
+    /** Our estimate of the serialized size of a single MovementState.
+        entity (4B) + bit-packed input (1B) + position (12B) + velocity (12B)
+        + rotation (1B). */
+    static constexpr std::size_t MOVEMENT_STATE_SIZE{30};
+
+    /** The max number of movement state bytes that we'll send to a single
+        client per sim tick, derived from the per-network-tick budget. */
+    static constexpr std::size_t BYTES_PER_SIM_TICK{static_cast<std::size_t>(
+        Config::MOVEMENT_SYNC_BYTES_PER_NETWORK_TICK
+        * (SharedConfig::SIM_TICK_TIMESTEP_S
+           / SharedConfig::NETWORK_TICK_TIMESTEP_S))};
+
+    /** The max number of entities that we'll send to a single client per
+        sim tick. Bounded by the MovementUpdate serializer's limit. */
+    static constexpr std::size_t MAX_STATES_PER_SIM_TICK{
+        std::min(BYTES_PER_SIM_TICK / MOVEMENT_STATE_SIZE,
+                 MovementUpdate::MAX_STATES)};
+
+    /**
+     * An entity that's eligible to be sent this tick, along with its
+     * priority.
+     */
+    struct SyncCandidate {
+        /** The index of this candidate in the client's pendingMovementSyncs
+            vector. */
+        std::size_t pendingIndex{0};
+
+        /** This candidate's priority. Lower values are sent first. */
+        float priority{0};
+    };
+
+    /**
+     * Scratch data for a single region. Kept between ticks so its
+     * allocations are re-used.
+     */
+    struct RegionScratch {
+        /** Holds the entities that a particular client needs to be sent
+            updates for. */
+        std::vector<entt::entity> entitiesToSend;
+
+        /** Holds the pending entities that are due to be sent to a
+            particular client, before they're ranked and budgeted. */
+        std::vector<SyncCandidate> syncCandidates;
+
+        /** Scratch space for building a client's new pending list. Swapped
+            with the client's list after each update, so neither reallocates
+            once they've grown. */
+        std::vector<ClientSimData::PendingSync> mergedPendingSyncs;
+    };
+
+    /**
+     * Sends movement updates to the given client, if it needs any.
+     *
+     * Note: This may run on a worker thread. It only modifies the given
+     *       client, and only reads everything else.
+     *
+     * @param regionIndex  The region that owns the client.
+     */
+    void updateClient(ClientSimData& client, entt::entity clientEntity,
+                      std::size_t regionIndex);
+
     /**
      * Determines which entity's data needs to be sent to the given client and
-     * adds them to entitiesToSend.
+     * adds them to scratch.entitiesToSend.
      *
      * Will add any entities that have just entered the client's AOI, and any
-     * entities already within the client's AOI that have changed input state.
+     * entities already within the client's AOI that have changed input state,
+     * as long as they're due to be sent and fit within the client's budget.
+     * Entities that just entered are always added, regardless of budget.
+     * Entities that aren't sent are left in client.pendingMovementSyncs.
      */
     void collectEntitiesToSend(ClientSimData& client,
-                               entt::entity clientEntity);
+                               entt::entity clientEntity,
+                               RegionScratch& scratch);
+
+    /**
+     * Adds any entities that need to be synced to the given client's
+     * pendingMovementSyncs, and removes any that have left its AOI.
+     */
+    void updatePendingSyncs(ClientSimData& client, RegionScratch& scratch);
+
+    /**
+     * Returns the number of ticks that an entity at the given squared
+     * distance from a client should wait between syncs.
+     */
+    static unsigned int getSyncInterval(float distanceSquared);
 
     /**
      * Adds the movement state of all entities in entitiesToSend to an
      * EntityUpdate message and sends it to the given client.
+     *
+     * @param tickArena  The arena to allocate the message from.
      */
-    void sendEntityUpdate(ClientSimData& client);
+    void sendEntityUpdate(ClientSimData& client,
+                          const std::vector<entt::entity>& entitiesToSend,
+                          std::pmr::memory_resource& tickArena);
 
     /** Used to get the current tick. */
     Simulation& simulation;
@@ -61,10 +165,12 @@ private:
     World& world;
     /** Used to send movement update messages. */
     Network& network;
+    /** Used to get each region's clients and tick arena, and run the region
+        jobs. */
+    SimRegions& simRegions;
 
-    /** Holds the entities that a particular client needs to be sent updates
-        for. */
-    std::vector<entt::entity> entitiesToSend;
+    /** Each region's scratch data, indexed by region. */
+    std::vector<RegionScratch> regionScratch;
 };
 
 } // namespace Server
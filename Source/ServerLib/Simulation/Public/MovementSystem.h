@@ -1,29 +1,62 @@
 #pragma once
 
+#include "MovementBatch.h"
+#include "EnttGroups.h"
+#include <vector>
+#include <cstddef>
+
 namespace AM
 {
 namespace Server
 {
 class World;
+class SimRegions;
 
 /**
  * Moves entities.
+ *
+ * Moving entities are sorted into the map's regions (see SimRegions), and
+ * each region's entities are moved on their own thread. Since collision only
+ * reads the tile map, regions don't conflict. Anything that's shared between
+ * regions (the entity locator, IsMoving tags) is updated afterwards on the
+ * sim thread.
  */
 class MovementSystem
 {
 public:
-    MovementSystem(World& inWorld);
+    MovementSystem(World& inWorld, SimRegions& inSimRegions);
 
     /**
      * Processes 1 tick of entity movement.
      *
      * Updates velocity components based on input state, moves position
      * components based on velocity, updates sprites based on position.
+     *
+     * Only entities with an IsMoving component are processed. Entities
+     * that come to rest have it removed.
      */
     void processMovements();
 
 private:
+    /**
+     * Moves the entities in the given region's batch, resolving collisions
+     * and updating their components.
+     */
+    void moveRegion(std::size_t regionIndex);
+
     World& world;
+
+    /** Used to sort entities into regions and run the region jobs. */
+    SimRegions& simRegions;
+
+    /** The movement group. Only valid while region jobs are running.
+        Getting a group may modify the registry, so processMovements() gets
+        it on the sim thread and the workers use this. */
+    EnttGroups::MovementGroup* movementGroup;
+
+    /** Scratch storage for each region's moving entities. Kept as a member
+        so its allocations are re-used between ticks. */
+    std::vector<MovementBatch> regionBatches;
 };
 
 } // namespace Server
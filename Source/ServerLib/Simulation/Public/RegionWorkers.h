@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Tracy.hpp"
+#include <SDL_stdinc.h>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * Runs a job once for each of the sim's regions, in parallel.
+ *
+ * Region 0 is processed on the calling thread, and every other region is
+ * given its own persistent worker thread. run() blocks until every region's
+ * job has finished, so the caller can treat it as a normal function call.
+ * The same workers are shared by every system that processes regions.
+ *
+ * Jobs for different regions must not touch the same data. Anything that
+ * isn't partitioned by region (e.g. the entity locator) should be updated
+ * by the caller after run() returns.
+ */
+class RegionWorkers
+{
+public:
+    /**
+     * @param inRegionCount  The number of regions. Must be at least 1.
+     */
+    RegionWorkers(std::size_t inRegionCount);
+
+    ~RegionWorkers();
+
+    /**
+     * Runs the given job for every region, returning once they've all
+     * finished.
+     *
+     * @param regionJob  The job to run. Called with each region's index.
+     */
+    void run(const std::function<void(std::size_t)>& regionJob);
+
+private:
+    /**
+     * Thread function, started from constructor.
+     *
+     * Waits for run() to signal that a new round has started, runs the job
+     * for the given region, then signals that it's done.
+     */
+    void processRegion(std::size_t regionIndex);
+
+    /** The job for the current round. Only valid while run() is
+        running. */
+    const std::function<void(std::size_t)>* currentJob;
+
+    /** The threads for regions 1 and up. */
+    std::vector<std::thread> workerThreads;
+
+    /** Used for signaling the worker threads. */
+    TracyLockable(std::mutex, workerMutex);
+    /** Signaled by run() when a new round starts. */
+    std::condition_variable_any startCondVar;
+    /** Signaled by the last worker to finish a round. */
+    std::condition_variable_any doneCondVar;
+
+    /** Incremented by run() each round, so the workers can tell when a new
+        round has started. */
+    Uint64 roundNumber;
+    /** The number of workers that haven't finished the current round. */
+    std::size_t workersRemaining;
+    /** Turn true to signal that the worker threads should end. */
+    bool exitRequested;
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "RegionWorkers.h"
+#include "TickArena.h"
+#include "entt/fwd.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+namespace AM
+{
+struct Position;
+
+namespace Server
+{
+class World;
+
+/**
+ * Splits the map into a grid of rectangular regions, and runs per-region
+ * work on each region's worker (see RegionWorkers).
+ *
+ * Each client entity is owned by the region that its position is in.
+ * Systems that do per-client work (AOI, movement sync) process each
+ * region's clients on that region's worker. Ownership is reassigned every
+ * tick after movement, so a client that crosses a border is handed off to
+ * its new region before those systems run.
+ *
+ * All regions share one World, so a client near a border still sees the
+ * entities on the other side of it: AOI queries go through the shared
+ * entity locator, and other regions' components are only read while
+ * region jobs are running.
+ *
+ * Rules for region jobs:
+ *   Only modify the data of entities that the region owns (e.g. its
+ *   clients' ClientSimData).
+ *   Only read the registry, the tile map, and the entity locator. Anything
+ *   that modifies them must be done on the sim thread, before or after
+ *   run().
+ *   Allocate scratch data from the region's tick arena, or from per-region
+ *   scratch containers.
+ *   Messages may be sent to the region's own clients. Each client is only
+ *   sent to from one thread at a time.
+ *
+ * Configure through Config::SIM_REGION_COLUMNS and Config::SIM_REGION_ROWS.
+ */
+class SimRegions
+{
+public:
+    SimRegions(World& inWorld);
+
+    /**
+     * Returns the number of regions.
+     */
+    std::size_t getRegionCount() const;
+
+    /**
+     * Returns the index of the region that the given position is in.
+     * Positions outside of the map are clamped to the nearest region.
+     */
+    std::size_t getRegionIndex(const Position& position) const;
+
+    /**
+     * Reassigns each client entity to the region that it's currently in.
+     * Must be called on the sim thread, after entities have moved.
+     */
+    void updateClientOwnership();
+
+    /**
+     * Returns the client entities that the given region owns, as of the
+     * last updateClientOwnership().
+     */
+    const std::vector<entt::entity>&
+        getClientEntities(std::size_t regionIndex) const;
+
+    /**
+     * Returns the given region's tick arena. Only use it from that
+     * region's job.
+     */
+    TickArena& getTickArena(std::size_t regionIndex);
+
+    /**
+     * Runs the given job for every region in parallel, returning once
+     * they've all finished.
+     *
+     * @param regionJob  The job to run. Called with each region's index.
+     */
+    void run(const std::function<void(std::size_t)>& regionJob);
+
+    /**
+     * Frees everything that was allocated from the regions' tick arenas.
+     * Called by the Simulation at the end of each tick.
+     */
+    void resetTickArenas();
+
+private:
+    /** The initial size of each region's tick arena, in bytes. */
+    static constexpr std::size_t TICK_ARENA_INITIAL_SIZE{64 * 1024};
+
+    /** Used to get the map size and client entities. */
+    World& world;
+
+    /** The width of a region, in world units. */
+    float regionWidth;
+
+    /** The height of a region, in world units. */
+    float regionHeight;
+
+    /** The client entities that each region owns, indexed by region. */
+    std::vector<std::vector<entt::entity>> regionClients;
+
+    /** Each region's tick arena, indexed by region.
+        Note: Arenas aren't movable, so we hold them by pointer. */
+    std::vector<std::unique_ptr<TickArena>> regionTickArenas;
+
+    /** Runs per-region jobs. */
+    RegionWorkers regionWorkers;
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "World.h"
+#include "SimRegions.h"
 #include "ClientConnectionSystem.h"
 #include "TileUpdateSystem.h"
 #include "ClientAOISystem.h"
@@ -9,6 +10,8 @@
 #include "MovementSyncSystem.h"
 #include "ChunkStreamingSystem.h"
 #include "MapSaveSystem.h"
+#include "TickArena.h"
+#include "Timer.h"
 #include <SDL_stdinc.h>
 #include <atomic>
 
@@ -34,6 +37,21 @@ public:
     /** An unreasonable amount of time for the sim tick to be late by. */
     static constexpr double SIM_DELAYED_TIME_S = .001;
 
+    /**
+     * How long each system took to run during the last tick, in seconds.
+     * Project extension functions aren't included.
+     */
+    struct SystemTimings {
+        double clientConnection{0};
+        double tileUpdate{0};
+        double input{0};
+        double movement{0};
+        double clientAOI{0};
+        double movementSync{0};
+        double chunkStreaming{0};
+        double mapSave{0};
+    };
+
     Simulation(Network& inNetwork, SpriteData& inSpriteData);
 
     /**
@@ -46,6 +64,11 @@ public:
 
     Uint32 getCurrentTick();
 
+    /**
+     * Returns how long each system took to run during the last tick.
+     */
+    const SystemTimings& getSystemTimings() const;
+
     /**
      * See extension member comment.
      */
@@ -61,6 +84,23 @@ private:
     /** The tick number that we're currently on. */
     std::atomic<Uint32> currentTick;
 
+    /** Used to time each system. */
+    Timer systemTimer;
+
+    /** How long each system took to run during the last tick. */
+    SystemTimings systemTimings;
+
+    /** The initial size of the tick arena, in bytes. */
+    static constexpr std::size_t TICK_ARENA_INITIAL_SIZE{256 * 1024};
+
+    /** Holds scratch data that only lives for a single tick. Reset at the
+        end of each tick. */
+    TickArena tickArena;
+
+    /** Splits the map into regions that are processed in parallel. Owns
+        each region's tick arena, which is reset along with ours. */
+    SimRegions simRegions;
+
     /** If non-nullptr, contains the project's simulation extension functions.
         Allows the project to provide simulation code and have it be called at
         the appropriate time. */
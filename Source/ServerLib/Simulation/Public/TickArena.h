@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * A monotonic allocator for data that only needs to live for a single sim
+ * tick, such as message structs and system scratch containers.
+ *
+ * Systems build std::pmr containers on top of this arena. Allocations are a
+ * pointer bump, deallocations are no-ops, and everything is freed at once
+ * when the Simulation calls reset() at the end of each tick.
+ *
+ * If a tick overflows the arena's buffer, the extra memory comes from the
+ * heap, and the buffer is grown on the next reset(). This way, steady-state
+ * ticks don't touch the heap at all.
+ *
+ * Note: This isn't thread-safe. Only use it from the thread that owns it
+ *       (the sim thread, or a single region's worker, see SimRegions), and
+ *       don't hold onto anything allocated from it past the end of the
+ *       tick.
+ */
+class TickArena : public std::pmr::memory_resource
+{
+public:
+    /**
+     * @param inInitialSize  The initial size of the arena's buffer, in bytes.
+     */
+    TickArena(std::size_t inInitialSize);
+
+    /**
+     * Frees everything that was allocated since the last reset.
+     * If the buffer was overflowed, grows it to fit.
+     */
+    void reset();
+
+private:
+    /**
+     * Forwards to the heap, tracking how many bytes were requested.
+     * Used as the arena's upstream, to find out if it overflowed.
+     */
+    class OverflowResource : public std::pmr::memory_resource
+    {
+    public:
+        /** The number of bytes that have been requested since the last
+            reset. */
+        std::size_t bytesAllocated{0};
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes,
+                           std::size_t alignment) override;
+        bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* p, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override;
+
+    /** The arena's buffer. */
+    std::unique_ptr<std::byte[]> buffer;
+
+    /** The size of buffer, in bytes. */
+    std::size_t bufferSize;
+
+    /** Provides memory when the buffer is full. */
+    OverflowResource overflowResource;
+
+    /** Hands out memory from the buffer.
+        Note: This is re-constructed when the buffer is grown. Systems hold
+              references to this class, so they aren't affected. */
+    std::optional<std::pmr::monotonic_buffer_resource> bufferResource;
+};
+
+} // End namespace Server
+} // End namespace AM
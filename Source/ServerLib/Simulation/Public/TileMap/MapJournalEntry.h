@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ChunkSnapshot.h"
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * A single record in the tile map's journal file.
+ *
+ * Holds the full state of a chunk that changed since the last time the map
+ * was journaled. On startup, entries are applied on top of TileMap.bin in
+ * the order that they were written.
+ *
+ * In the file, each entry is prefixed by its serialized size as a 32-bit
+ * little-endian int.
+ */
+struct MapJournalEntry {
+public:
+    /** The X position of the chunk, in chunks. */
+    int chunkX{0};
+
+    /** The Y position of the chunk, in chunks. */
+    int chunkY{0};
+
+    /** The chunk's state. */
+    ChunkSnapshot chunkSnapshot{};
+};
+
+template<typename S>
+void serialize(S& serializer, MapJournalEntry& mapJournalEntry)
+{
+    serializer.value4b(mapJournalEntry.chunkX);
+    serializer.value4b(mapJournalEntry.chunkY);
+    serializer.object(mapJournalEntry.chunkSnapshot);
+}
+
+} // End namespace Server
+} // End namespace AM
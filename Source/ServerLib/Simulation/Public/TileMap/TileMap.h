@@ -1,10 +1,16 @@
 #pragma once
 
 #include "TileMapBase.h"
+#include "ChunkSnapshot.h"
+#include "SharedConfig.h"
+#include <SDL_stdinc.h>
+#include <memory>
+#include <vector>
+#include <string>
+#include <unordered_map>
 
 namespace AM
 {
-struct TileMapSnapshot;
 namespace Server
 {
 class SpriteData;
@@ -13,7 +19,23 @@ class SpriteData;
  * Owns and manages the world's tile map state.
  * Tiles are conceptually organized into 16x16 chunks.
  *
- * Persisted tile map data is loaded from TileMap.bin.
+ * Persisted tile map data is loaded from TileMap.bin. Chunks that changed
+ * since the last full save are appended to TileMap.journal (see
+ * appendToJournal()), which is replayed on top of TileMap.bin at startup.
+ * Full saves fold the journal back into TileMap.bin (see compactJournal()).
+ *
+ * TileMap.bin uses an indexed format, so it can be read straight out of a
+ * memory-mapped file. All values are little-endian:
+ *   Header:       Uint16 version, Uint32 xLengthChunks,
+ *                 Uint32 yLengthChunks, Uint32 paletteCount
+ *   Palette:      paletteCount entries of (Uint8 length, char[length]),
+ *                 holding the string IDs of every sprite used in the map.
+ *   Chunk table:  One (Uint32 offset, Uint32 size) entry per chunk, in
+ *                 row-major order. An offset of 0 means the chunk is empty.
+ *   Chunk blocks: LZ4-compressed chunk data. Each tile is a Uint8 layer
+ *                 count, followed by that many Uint16 palette indices.
+ *
+ * Version 0 map files are upgraded when they're loaded.
  *
  * Note: This class expects a TileMap.bin file to be present in the same
  *       directory as the application executable.
@@ -29,23 +51,228 @@ public:
     TileMap(SpriteData& inSpriteData);
 
     /**
-     * Attempts to save the current tile map state to TileMap.bin.
+     * If saving is enabled, attempts to save the current tile map state to
+     * TileMap.bin, and clear the journal.
      */
     ~TileMap();
 
     /**
-     * Saves the map to a file with the given name, placed in the same
-     * directory as the program binary.
+     * Sets whether this map should be saved to disk (periodically by
+     * MapSaveSystem, and when it's destroyed). Enabled by default.
+     *
+     * Tools that replay or benchmark the simulation can disable saving, so
+     * they don't modify the map files and every run starts from the same
+     * state.
+     */
+    void setSavingEnabled(bool inSavingEnabled);
+
+    /**
+     * Returns true if this map should be saved to disk.
+     */
+    bool getSavingEnabled() const;
+
+    /**
+     * An immutable copy of the map's chunks, cheap enough to take on the sim
+     * thread.
+     *
+     * The chunks are shared with the map, which copies any chunk that it
+     * modifies while a snapshot is held (see TileMapBase::getChunkSnapshot()).
+     */
+    struct SaveSnapshot {
+        /** The map's extent, with chunks as the unit. */
+        ChunkExtent chunkExtent{};
+
+        /** The map's chunks, stored in row-major order. */
+        std::vector<std::shared_ptr<const Chunk>> chunks{};
+    };
+
+    /**
+     * An immutable copy of a set of the map's chunks, cheap enough to take on
+     * the sim thread.
+     */
+    struct JournalSnapshot {
+        /** The positions of the chunks. */
+        std::vector<ChunkPosition> chunkPositions{};
+
+        /** The chunks, in the same order as chunkPositions. */
+        std::vector<std::shared_ptr<const Chunk>> chunks{};
+    };
+
+    /**
+     * Returns a snapshot of the map's current state, to pass to
+     * compactJournal().
+     */
+    SaveSnapshot getSaveSnapshot() const;
+
+    /**
+     * Returns a snapshot of the given chunks' current state, to pass to
+     * appendToJournal().
+     */
+    JournalSnapshot getJournalSnapshot(
+        const std::vector<ChunkPosition>& chunkPositions) const;
+
+    /**
+     * Appends the given chunks to TileMap.journal.
+     *
+     * Note: This only reads the given snapshot, so it's safe to call from
+     *       any thread. Calls to this and compactJournal() must all come
+     *       from the same thread.
+     *
+     * @param[out] bytesWritten  The number of bytes that were appended.
+     * @return true if the append was successful, else false.
+     */
+    bool appendToJournal(const JournalSnapshot& snapshot,
+                         std::size_t& bytesWritten) const;
+
+    /**
+     * Saves the given snapshot to TileMap.bin and clears the journal.
+     *
+     * The snapshot must have been taken after all of the journal's current
+     * entries. If we crash partway through, the next startup will finish or
+     * roll back the compaction (see recoverCompaction()).
      *
-     * @param fileName  The file name to save to, with no path prepended.
+     * The map file is written to a temporary file, which then replaces
+     * TileMap.bin, so a failed save never leaves a partially written map.
+     *
+     * Note: This only reads the given snapshot and the (immutable) sprite
+     *       data, so it's safe to call from any thread.
+     *
+     * @param[out] bytesWritten  The size of the written map file.
+     * @return true if the save was successful, else false.
      */
-    void save(const std::string& fileName);
+    bool compactJournal(const SaveSnapshot& snapshot,
+                        std::size_t& bytesWritten) const;
 
 private:
+    /** The name of the map file, in the same directory as the program
+        binary. */
+    static constexpr const char* MAP_FILE_NAME{"TileMap.bin"};
+
+    /** The name of the journal file. */
+    static constexpr const char* JOURNAL_FILE_NAME{"TileMap.journal"};
+
+    /** The name that the journal is moved to while it's being compacted. */
+    static constexpr const char* COMPACTING_JOURNAL_FILE_NAME{
+        "TileMap.journal.compacting"};
+
+    /** The size of the map file's header. */
+    static constexpr std::size_t HEADER_SIZE{14};
+
+    /** The size of each entry in the map file's chunk table. */
+    static constexpr std::size_t CHUNK_TABLE_ENTRY_SIZE{8};
+
+    /** The largest that a chunk's data can be, before compression. */
+    static constexpr std::size_t MAX_CHUNK_DATA_SIZE{
+        SharedConfig::CHUNK_TILE_COUNT
+        * (1 + (sizeof(Uint16) * SharedConfig::MAX_TILE_LAYERS))};
+
     /**
-     * Loads the given snapshot's data into this map.
+     * Sets the map's extent and allocates its chunks.
      */
-    void load(TileMapSnapshot& mapSnapshot);
+    void setMapSize(unsigned int inMapXLengthChunks,
+                    unsigned int inMapYLengthChunks);
+
+    /**
+     * Loads the version 0 map file at the given path.
+     */
+    void loadVersion0(const std::string& mapPath);
+
+    /**
+     * Loads the given version 1 map file data into this map.
+     */
+    void loadVersion1(const Uint8* fileData, std::size_t fileSize);
+
+    /**
+     * A chunk block that needs to be decoded.
+     */
+    struct DecodeJob {
+        /** The position of the chunk. */
+        ChunkPosition chunkPosition{};
+
+        /** The chunk's compressed data. */
+        const Uint8* chunkBlock{nullptr};
+
+        /** The size of chunkBlock. */
+        std::size_t blockSize{0};
+
+        /** The chunk to decode into. */
+        Chunk* chunk{nullptr};
+    };
+
+    /** When loading, the minimum number of chunks that each thread must
+        have to decode. Any less and it isn't worth starting a thread. */
+    static constexpr std::size_t MIN_CHUNKS_PER_LOAD_THREAD{256};
+
+    /**
+     * Decodes the given chunk blocks and builds their collision data, spread
+     * across as many threads as are useful.
+     */
+    void decodeChunks(const std::vector<DecodeJob>& decodeJobs,
+                      const std::vector<int>& paletteIDs);
+
+    /**
+     * Decompresses the given chunk block and copies its tiles into the
+     * given chunk.
+     *
+     * @param paletteIDs  The numeric sprite ID for each of the file's
+     *                    palette entries.
+     */
+    void decodeChunk(const Uint8* chunkBlock, std::size_t blockSize,
+                     const std::vector<int>& paletteIDs, Chunk& chunk) const;
+
+    /**
+     * Writes the given chunk's tiles into chunkData, adding any new sprites
+     * to the palette.
+     *
+     * @param chunkData  A buffer of at least MAX_CHUNK_DATA_SIZE bytes.
+     * @param paletteIndices  A map of numeric sprite ID -> palette index.
+     * @param palette  The numeric sprite ID for each palette entry.
+     * @return The number of bytes written into chunkData.
+     */
+    std::size_t encodeChunk(const Chunk& chunk, Uint8* chunkData,
+                            std::unordered_map<int, Uint16>& paletteIndices,
+                            std::vector<int>& palette) const;
+
+    /**
+     * Replaces the chunk at the given position with the given (string
+     * palette) snapshot's data.
+     * Used for version 0 map files and journal entries.
+     */
+    void loadChunk(const ChunkPosition& chunkPosition,
+                   const ChunkSnapshot& chunkSnapshot);
+
+    /**
+     * Copies the given chunk's data into the given (empty) string palette
+     * snapshot.
+     * Used for journal entries.
+     */
+    void saveChunk(const Chunk& chunk, ChunkSnapshot& chunkSnapshot) const;
+
+    /**
+     * Encodes the given snapshot into the current map format and writes it
+     * to the given path.
+     */
+    bool writeSnapshotToFile(const SaveSnapshot& snapshot,
+                             const std::string& filePath,
+                             std::size_t& bytesWritten) const;
+
+    /**
+     * If the last compaction was interrupted, finishes or rolls it back.
+     *
+     * compactJournal() writes TileMap.bin.tmp, moves the journal aside,
+     * replaces TileMap.bin, then deletes the old journal. Depending on
+     * which files exist, we can tell how far it got.
+     */
+    void recoverCompaction();
+
+    /**
+     * Applies any entries in TileMap.journal to this map.
+     */
+    void replayJournal();
+
+    /** If false, we won't save the map when we're destroyed, and
+        MapSaveSystem won't save it periodically. */
+    bool savingEnabled;
 };
 
 } // End namespace Server
@@ -3,7 +3,10 @@
 #include "QueuedEvents.h"
 #include "TileUpdateRequest.h"
 #include "TileUpdate.h"
-#include <unordered_map>
+#include "ChunkPosition.h"
+#include "TilePosition.h"
+#include <memory_resource>
+#include <vector>
 
 namespace AM
 {
@@ -24,7 +27,8 @@ class TileUpdateSystem
 public:
     TileUpdateSystem(World& inWorld, EventDispatcher& inNetworkEventDispatcher,
                      Network& inNetwork,
-                     const std::unique_ptr<ISimulationExtension>& inExtension);
+                     const std::unique_ptr<ISimulationExtension>& inExtension,
+                     std::pmr::memory_resource& inTickArena);
 
     /**
      * Processes tile updates and updates the world's tile map.
@@ -46,9 +50,17 @@ private:
         Used for checking if tile updates are valid. */
     const std::unique_ptr<ISimulationExtension>& extension;
 
-    /** Holds tile updates as we iterate the dirty tiles and figure out what
-        needs to be sent to each client. */
-    std::unordered_map<NetworkID, TileUpdate> workingUpdates;
+    /** Used to allocate the dirty tiles while we group them by chunk. */
+    std::pmr::memory_resource& tickArena;
+
+    /**
+     * Fills the given update with the dirty state of the given tiles.
+     */
+    void fillTileUpdate(const std::pmr::vector<TilePosition>& tilePositions,
+                        TileUpdate& tileUpdate);
+
+    /** Holds the tile update that we're building for a particular chunk. */
+    TileUpdate workingUpdate;
 
     EventQueue<TileUpdateRequest> tileUpdateRequestQueue;
 };
@@ -5,10 +5,10 @@
 #include "Position.h"
 #include "EntityLocator.h"
 #include "SpawnStrategy.h"
+#include "SlotMap.h"
 
 #include "entt/entity/registry.hpp"
 
-#include <unordered_map>
 #include <random>
 
 namespace AM
@@ -46,7 +46,7 @@ public:
 
     /** Maps network IDs to entity IDs.
         Used for interfacing with the Network. */
-    std::unordered_map<NetworkID, entt::entity> netIdMap;
+    SlotMap<entt::entity> netIdMap;
 
     /**
      * Returns the spawn point position.
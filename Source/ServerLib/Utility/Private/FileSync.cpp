@@ -0,0 +1,100 @@
+#include "FileSync.h"
+#include "Log.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace AM
+{
+namespace Server
+{
+#if defined(_WIN32)
+bool FileSync::syncFile(const std::string& filePath)
+{
+    // Note: FlushFileBuffers() requires write access.
+    HANDLE fileHandle{CreateFileA(filePath.c_str(), GENERIC_WRITE,
+                                  (FILE_SHARE_READ | FILE_SHARE_WRITE),
+                                  nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Failed to open file for syncing: %s",
+                  filePath.c_str());
+        return false;
+    }
+
+    bool wasSuccessful{FlushFileBuffers(fileHandle) != 0};
+    CloseHandle(fileHandle);
+    if (!wasSuccessful) {
+        LOG_ERROR("Failed to sync file: %s", filePath.c_str());
+    }
+
+    return wasSuccessful;
+}
+
+bool FileSync::syncDirectory(const std::string&)
+{
+    return true;
+}
+#else
+/**
+ * Syncs the given descriptor, then closes it.
+ */
+static bool syncAndClose(int fileDescriptor, bool isDirectory)
+{
+#if defined(__linux__)
+    // Note: fdatasync() skips metadata that isn't needed to read the data
+    //       back (e.g. timestamps), but directories need a full fsync().
+    int result{isDirectory ? fsync(fileDescriptor)
+                           : fdatasync(fileDescriptor)};
+#else
+    static_cast<void>(isDirectory);
+    int result{fsync(fileDescriptor)};
+#endif
+    close(fileDescriptor);
+    return (result == 0);
+}
+
+bool FileSync::syncFile(const std::string& filePath)
+{
+    int fileDescriptor{open(filePath.c_str(), O_WRONLY)};
+    if (fileDescriptor < 0) {
+        LOG_ERROR("Failed to open file for syncing: %s",
+                  filePath.c_str());
+        return false;
+    }
+
+    if (!syncAndClose(fileDescriptor, false)) {
+        LOG_ERROR("Failed to sync file: %s", filePath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool FileSync::syncDirectory(const std::string& directoryPath)
+{
+    int directoryDescriptor{
+        open(directoryPath.c_str(), (O_RDONLY | O_DIRECTORY))};
+    if (directoryDescriptor < 0) {
+        LOG_ERROR("Failed to open directory for syncing: %s",
+                  directoryPath.c_str());
+        return false;
+    }
+
+    if (!syncAndClose(directoryDescriptor, true)) {
+        LOG_ERROR("Failed to sync directory: %s", directoryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,130 @@
+#include "MappedFile.h"
+#include "Log.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace AM
+{
+namespace Server
+{
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& filePath)
+: fileData{nullptr}
+, fileSize{0}
+, mappingHandle{nullptr}
+{
+    // Open the file.
+    HANDLE fileHandle{CreateFileA(filePath.c_str(), GENERIC_READ,
+                                  FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("Failed to open file: %s", filePath.c_str());
+        return;
+    }
+
+    // Get its size. If it's empty, there's nothing to map.
+    LARGE_INTEGER largeFileSize{};
+    if (!GetFileSizeEx(fileHandle, &largeFileSize)
+        || (largeFileSize.QuadPart == 0)) {
+        CloseHandle(fileHandle);
+        return;
+    }
+
+    // Map it.
+    // Note: The mapping keeps the file open, so we can close our handle.
+    mappingHandle
+        = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(fileHandle);
+    if (mappingHandle == nullptr) {
+        LOG_ERROR("Failed to map file: %s", filePath.c_str());
+        return;
+    }
+
+    void* view{MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0)};
+    if (view == nullptr) {
+        LOG_ERROR("Failed to map file: %s", filePath.c_str());
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+        return;
+    }
+
+    fileData = static_cast<const Uint8*>(view);
+    fileSize = static_cast<std::size_t>(largeFileSize.QuadPart);
+}
+
+MappedFile::~MappedFile()
+{
+    if (fileData != nullptr) {
+        UnmapViewOfFile(fileData);
+    }
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& filePath)
+: fileData{nullptr}
+, fileSize{0}
+{
+    // Open the file.
+    int fileDescriptor{open(filePath.c_str(), O_RDONLY)};
+    if (fileDescriptor < 0) {
+        LOG_ERROR("Failed to open file: %s", filePath.c_str());
+        return;
+    }
+
+    // Get its size. If it's empty, there's nothing to map.
+    struct stat fileStat {};
+    if ((fstat(fileDescriptor, &fileStat) != 0) || (fileStat.st_size == 0)) {
+        close(fileDescriptor);
+        return;
+    }
+
+    // Map it.
+    // Note: The mapping keeps the file open, so we can close our descriptor.
+    void* mapping{mmap(nullptr, static_cast<std::size_t>(fileStat.st_size),
+                       PROT_READ, MAP_PRIVATE, fileDescriptor, 0)};
+    close(fileDescriptor);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map file: %s", filePath.c_str());
+        return;
+    }
+
+    fileData = static_cast<const Uint8*>(mapping);
+    fileSize = static_cast<std::size_t>(fileStat.st_size);
+}
+
+MappedFile::~MappedFile()
+{
+    if (fileData != nullptr) {
+        munmap(const_cast<Uint8*>(fileData), fileSize);
+    }
+}
+#endif
+
+bool MappedFile::isOpen() const
+{
+    return (fileData != nullptr);
+}
+
+const Uint8* MappedFile::data() const
+{
+    return fileData;
+}
+
+std::size_t MappedFile::size() const
+{
+    return fileSize;
+}
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * This file contains helper functions for making sure that written files
+ * survive a crash or power loss.
+ *
+ * Flushing a stream only hands its data to the OS, which may hold it in
+ * memory for a while before writing it to disk. These functions block until
+ * the OS has written it.
+ */
+class FileSync
+{
+public:
+    /**
+     * Blocks until the contents of the file at the given path are written
+     * to disk.
+     * The file should already be closed, or at least flushed.
+     *
+     * Uses fdatasync() on Linux, fsync() on other POSIX systems, and
+     * FlushFileBuffers() on Windows.
+     *
+     * @return true if successful, else false.
+     */
+    static bool syncFile(const std::string& filePath);
+
+    /**
+     * Blocks until the entries of the directory at the given path are
+     * written to disk. Call this after creating, renaming, or removing a
+     * file, to make the change durable.
+     *
+     * On Windows, directory entries are made durable by NTFS's metadata
+     * journal, so this does nothing.
+     *
+     * @return true if successful, else false.
+     */
+    static bool syncDirectory(const std::string& directoryPath);
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL_stdinc.h>
+#include <string>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * A read-only, memory-mapped view of a file.
+ *
+ * The file's contents are paged in by the OS as they're accessed, so large
+ * files can be read without first copying them into a buffer.
+ *
+ * The mapping is released when this object is destroyed.
+ */
+class MappedFile
+{
+public:
+    /**
+     * Attempts to map the file at the given path.
+     * Use isOpen() to check if it was successful.
+     */
+    MappedFile(const std::string& filePath);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Returns true if the file was successfully mapped.
+     */
+    bool isOpen() const;
+
+    /**
+     * Returns a pointer to the start of the file's contents.
+     */
+    const Uint8* data() const;
+
+    /**
+     * Returns the size of the file, in bytes.
+     */
+    std::size_t size() const;
+
+private:
+    /** The start of the mapped file contents. */
+    const Uint8* fileData;
+
+    /** The size of the file, in bytes. */
+    std::size_t fileSize;
+
+#if defined(_WIN32)
+    /** The file mapping object's handle. */
+    void* mappingHandle;
+#endif
+};
+
+} // End namespace Server
+} // End namespace AM
@@ -99,6 +99,12 @@ public:
               so you may need to be conscious of this size in that case. */
     static constexpr std::size_t MAX_BATCH_SIZE{20'000};
 
+    /** The max size that a single message can be.
+        If a batch fills up, the rest of its messages are sent in another
+        batch. Messages that are larger than a whole batch are split into
+        fragments, and reassembled by the receiver (up to this size). */
+    static constexpr std::size_t MAX_MESSAGE_SIZE{1'000'000};
+
     //-------------------------------------------------------------------------
     // Renderer
     //-------------------------------------------------------------------------
@@ -30,6 +30,11 @@ struct ConnectionResponse {
     /** Position (spawn point or last logout). */
     float x{0};
     float y{0};
+
+    /** If non-0, the server is admitting other clients and we're waiting in
+        its join queue at this position. The other fields are invalid, and
+        another response will follow. */
+    Uint32 queuePosition{0};
 };
 
 template<typename S>
@@ -41,6 +46,7 @@ void serialize(S& serializer, ConnectionResponse& connectionResponse)
     serializer.value4b(connectionResponse.mapYLengthChunks);
     serializer.value4b(connectionResponse.x);
     serializer.value4b(connectionResponse.y);
+    serializer.value4b(connectionResponse.queuePosition);
 }
 
 } // End namespace AM
@@ -28,6 +28,7 @@ enum class MessageType : Uint8 {
     TileUpdate = 34,
     EntityInit = 35,
     EntityDelete = 36,
+    MessageFragment = 37,
 };
 
 } // End namespace AM
@@ -4,6 +4,7 @@
 #include "MessageType.h"
 #include "SharedConfig.h"
 #include <SDL_stdinc.h>
+#include <memory_resource>
 #include <vector>
 #include "bitsery/bitsery.h"
 
@@ -23,11 +24,19 @@ struct MovementUpdate {
     // Declares this struct as a message that the Network can send and receive.
     static constexpr MessageType MESSAGE_TYPE = MessageType::MovementUpdate;
 
+    /** Used as a "we should never hit this" cap on the number of states in a
+        single update.
+        Note: Large updates are fragmented by the network layer, so this
+              only needs to stay under SharedConfig::MAX_MESSAGE_SIZE. */
+    static constexpr std::size_t MAX_STATES{10'000};
+
     /** The tick that this update corresponds to. */
     Uint32 tickNum{0};
 
-    /** The new state of all relevant entities that updated on this tick. */
-    std::vector<MovementState> movementStates;
+    /** The new state of all relevant entities that updated on this tick.
+        Note: This is a pmr vector so the server can build it in its per-tick
+              arena. By default, it uses the heap like a normal vector. */
+    std::pmr::vector<MovementState> movementStates;
 };
 
 template<typename S>
@@ -37,7 +46,7 @@ void serialize(S& serializer, MovementUpdate& movementUpdate)
     serializer.enableBitPacking(
         [&movementUpdate](typename S::BPEnabledType& sbp) {
             sbp.container(movementUpdate.movementStates,
-                          static_cast<std::size_t>(SharedConfig::MAX_ENTITIES));
+                          MovementUpdate::MAX_STATES);
         });
 }
 
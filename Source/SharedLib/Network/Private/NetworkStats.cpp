@@ -5,6 +5,7 @@ namespace AM
 // Initialize data.
 std::atomic<std::size_t> NetworkStats::bytesSent = 0;
 std::atomic<std::size_t> NetworkStats::bytesReceived = 0;
+std::atomic<std::size_t> NetworkStats::inputsCoalesced = 0;
 
 NetStatsDump NetworkStats::dumpStats()
 {
@@ -13,6 +14,7 @@ NetStatsDump NetworkStats::dumpStats()
 
     netStatsDump.bytesSent = bytesSent.exchange(0);
     netStatsDump.bytesReceived = bytesReceived.exchange(0);
+    netStatsDump.inputsCoalesced = inputsCoalesced.exchange(0);
 
     return netStatsDump;
 }
@@ -27,4 +29,9 @@ void NetworkStats::recordBytesReceived(std::size_t inBytesReceived)
     bytesReceived += inBytesReceived;
 }
 
+void NetworkStats::recordInputsCoalesced(std::size_t inInputsCoalesced)
+{
+    inputsCoalesced += inInputsCoalesced;
+}
+
 } // End namespace AM
@@ -91,6 +91,27 @@ struct MessageHeaderIndex {
 static constexpr unsigned int MESSAGE_HEADER_SIZE{
     MessageHeaderIndex::MessageStart};
 
+/**
+ * Used for indexing into the payload of a MessageFragment message.
+ *
+ * Messages that are too large to fit in a single batch are split by the
+ * server into a series of MessageFragments, which are always sent
+ * consecutively. The client appends each fragment's bytes until it has the
+ * whole message, then processes it as if it had been received normally.
+ */
+struct MessageFragmentIndex {
+    enum Index : Uint8 {
+        /** Uint8, the type of the message that this fragment is a part of. */
+        MessageType = 0,
+        /** Uint32, the total size of that message's payload in bytes. */
+        TotalSize = 1,
+        /** The start of this fragment's bytes. */
+        FragmentStart = 5
+    };
+};
+static constexpr unsigned int MESSAGE_FRAGMENT_HEADER_SIZE{
+    MessageFragmentIndex::FragmentStart};
+
 //--------------------------------------------------------------------------
 // Enums, Structs
 //--------------------------------------------------------------------------
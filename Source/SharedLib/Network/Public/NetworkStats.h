@@ -9,6 +9,7 @@ namespace AM
 struct NetStatsDump {
     std::size_t bytesSent = 0;
     std::size_t bytesReceived = 0;
+    std::size_t inputsCoalesced = 0;
 };
 
 /**
@@ -36,6 +37,8 @@ public:
     static void recordBytesSent(std::size_t inBytesSent);
     /** Adds inBytesReceived to bytesReceived. */
     static void recordBytesReceived(std::size_t inBytesReceived);
+    /** Adds inInputsCoalesced to inputsCoalesced. */
+    static void recordInputsCoalesced(std::size_t inInputsCoalesced);
 
 private:
     /** The number of bytes that have been sent since the last dump. */
@@ -43,6 +46,10 @@ private:
 
     /** The number of bytes that have been received since the last dump. */
     static std::atomic<std::size_t> bytesReceived;
+
+    /** The number of received input changes that were merged into another
+        input or discarded as redundant since the last dump. */
+    static std::atomic<std::size_t> inputsCoalesced;
 };
 
 } // End namespace AM
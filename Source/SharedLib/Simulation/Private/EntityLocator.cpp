@@ -86,8 +86,16 @@ std::vector<entt::entity>&
     EntityLocator::getEntitiesCoarse(const Position& cylinderCenter,
                                      unsigned int radius)
 {
-    // Clear the return vector.
-    returnVector.clear();
+    getEntitiesCoarse(cylinderCenter, radius, returnVector);
+    return returnVector;
+}
+
+void EntityLocator::getEntitiesCoarse(
+    const Position& cylinderCenter, unsigned int radius,
+    std::vector<entt::entity>& outEntities) const
+{
+    // Clear the output vector.
+    outEntities.clear();
 
     // Calc the cell extent that is intersected by the cylinder.
     CellExtent cylinderCellExtent{};
@@ -107,25 +115,24 @@ std::vector<entt::entity>&
     // Clip the extent to the grid's bounds.
     cylinderCellExtent.intersectWith(cellExtent);
 
-    // Add the entities in every intersected cell to the return vector.
+    // Add the entities in every intersected cell to the output vector.
     int xMax{cylinderCellExtent.x + cylinderCellExtent.xLength};
     int yMax{cylinderCellExtent.y + cylinderCellExtent.yLength};
     for (int x = cylinderCellExtent.x; x < xMax; ++x) {
         for (int y = cylinderCellExtent.y; y < yMax; ++y) {
-            // Add the entities in this cell to the return vector.
+            // Add the entities in this cell to the output vector.
             unsigned int linearizedIndex{linearizeCellIndex(x, y)};
-            std::vector<entt::entity>& entityVec{entityGrid[linearizedIndex]};
-            returnVector.insert(returnVector.end(), entityVec.begin(),
-                                entityVec.end());
+            const std::vector<entt::entity>& entityVec{
+                entityGrid[linearizedIndex]};
+            outEntities.insert(outEntities.end(), entityVec.begin(),
+                               entityVec.end());
         }
     }
 
-    // Remove duplicates from the return vector.
-    std::sort(returnVector.begin(), returnVector.end());
-    returnVector.erase(std::unique(returnVector.begin(), returnVector.end()),
-                       returnVector.end());
-
-    return returnVector;
+    // Remove duplicates from the output vector.
+    std::sort(outEntities.begin(), outEntities.end());
+    outEntities.erase(std::unique(outEntities.begin(), outEntities.end()),
+                      outEntities.end());
 }
 
 std::vector<entt::entity>&
@@ -180,19 +187,27 @@ std::vector<entt::entity>&
 std::vector<entt::entity>&
     EntityLocator::getEntitiesFine(const Position& cylinderCenter,
                                    unsigned int radius)
+{
+    getEntitiesFine(cylinderCenter, radius, returnVector);
+    return returnVector;
+}
+
+void EntityLocator::getEntitiesFine(
+    const Position& cylinderCenter, unsigned int radius,
+    std::vector<entt::entity>& outEntities) const
 {
     // Run a coarse pass.
-    getEntitiesCoarse(cylinderCenter, radius);
+    getEntitiesCoarse(cylinderCenter, radius, outEntities);
 
     // Erase any entities that don't actually intersect the cylinder.
-    auto view{registry.view<Collision>()};
-    std::erase_if(
-        returnVector, [&view, &cylinderCenter, radius](entt::entity entity) {
-            Collision& collision{view.get<Collision>(entity)};
-            return !(collision.worldBounds.intersects(cylinderCenter, radius));
-        });
-
-    return returnVector;
+    // Note: We only read the registry, so this is safe to do from multiple
+    //       threads.
+    const entt::registry& constRegistry{registry};
+    std::erase_if(outEntities, [&constRegistry, &cylinderCenter,
+                                radius](entt::entity entity) {
+        const Collision& collision{constRegistry.get<Collision>(entity)};
+        return !(collision.worldBounds.intersects(cylinderCenter, radius));
+    });
 }
 
 std::vector<entt::entity>&
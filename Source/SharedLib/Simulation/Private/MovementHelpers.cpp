@@ -3,6 +3,7 @@
 #include "PreviousPosition.h"
 #include "Velocity.h"
 #include "Rotation.h"
+#include "MovementBatch.h"
 #include "BoundingBox.h"
 #include "SharedConfig.h"
 #include "Ignore.h"
@@ -96,6 +97,51 @@ Rotation MovementHelpers::updateRotation(const Rotation& rotation,
     }
 }
 
+void MovementHelpers::updateBatch(MovementBatch& batch, double deltaSeconds)
+{
+    // Note: This must match updateVelocity(), updatePosition(), and
+    //       updateRotation() exactly, since the client predicts its own
+    //       movement using the scalar functions.
+    const std::size_t count{batch.size()};
+    const int* xInputs{batch.xInputs.data()};
+    const int* yInputs{batch.yInputs.data()};
+    float* velocityXs{batch.velocityXs.data()};
+    float* velocityYs{batch.velocityYs.data()};
+    float* positionXs{batch.positionXs.data()};
+    float* positionYs{batch.positionYs.data()};
+    int* directions{batch.directions.data()};
+
+    for (std::size_t i = 0; i < count; ++i) {
+        // Calculate the direction vector.
+        float xDirection{static_cast<float>(xInputs[i])};
+        float yDirection{static_cast<float>(yInputs[i])};
+
+        // If moving diagonally, normalize the direction vector.
+        // Note: Multiplying by 1 is exact, so this matches the branch in
+        //       updateVelocity().
+        bool isDiagonal{(xInputs[i] != 0) & (yInputs[i] != 0)};
+        float normalization{isDiagonal ? DIAGONAL_NORMALIZATION_CONSTANT
+                                       : 1.0f};
+        xDirection *= normalization;
+        yDirection *= normalization;
+
+        // Apply the velocity.
+        velocityXs[i] = xDirection * SharedConfig::MOVEMENT_VELOCITY;
+        velocityYs[i] = yDirection * SharedConfig::MOVEMENT_VELOCITY;
+
+        // Update the position.
+        positionXs[i] += static_cast<float>((deltaSeconds * velocityXs[i]));
+        positionYs[i] += static_cast<float>((deltaSeconds * velocityYs[i]));
+
+        // Update the rotation. If there are no inputs or they're canceling,
+        // keep the current direction.
+        int directionInt{(3 * -yInputs[i]) + xInputs[i]};
+        directions[i] = (directionInt == Rotation::Direction::None)
+                            ? directions[i]
+                            : directionInt;
+    }
+}
+
 Position
     MovementHelpers::interpolatePosition(const PreviousPosition& previousPos,
                                          const Position& position, double alpha)
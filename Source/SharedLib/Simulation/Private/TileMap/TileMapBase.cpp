@@ -14,6 +14,7 @@
 #include "AMAssert.h"
 #include "Ignore.h"
 #include <algorithm>
+#include <atomic>
 
 namespace AM
 {
@@ -21,7 +22,11 @@ TileMapBase::TileMapBase(SpriteDataBase& inSpriteData, bool inTrackDirtyState)
 : spriteData{inSpriteData}
 , chunkExtent{}
 , tileExtent{}
-, tiles{}
+, chunks{}
+, chunkVersions{}
+, emptyChunk{std::make_shared<Chunk>()}
+, residentChunkCount{0}
+, chunkCollisions{}
 , trackDirtyState{inTrackDirtyState}
 {
 }
@@ -29,6 +34,20 @@ TileMapBase::TileMapBase(SpriteDataBase& inSpriteData, bool inTrackDirtyState)
 void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
                                      std::size_t layerIndex,
                                      const Sprite& sprite)
+{
+    setTileSpriteLayer(tileX, tileY, layerIndex, sprite.numericID);
+}
+
+void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
+                                     std::size_t layerIndex,
+                                     const std::string& stringID)
+{
+    setTileSpriteLayer(tileX, tileY, layerIndex,
+                       spriteData.get(stringID).numericID);
+}
+
+void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
+                                     std::size_t layerIndex, int numericID)
 {
     AM_ASSERT(tileX >= tileExtent.x, "x out of bounds: %d", tileX);
     AM_ASSERT(tileX <= tileExtent.xMax(), "x out of bounds: %d", tileX);
@@ -37,60 +56,53 @@ void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
     AM_ASSERT(layerIndex < SharedConfig::MAX_TILE_LAYERS,
               "Layer index out of bounds: %u", layerIndex);
 
-    Tile& tile{tiles[linearizeTileIndex(tileX, tileY)]};
-    std::vector<Tile::SpriteLayer>& spriteLayers{tile.spriteLayers};
-
     // If the layer is already set to the given sprite, exit early.
-    if ((spriteLayers.size() > layerIndex)
-        && (spriteLayers[layerIndex].sprite.numericID == sprite.numericID)) {
+    // Note: We check this before getting a mutable ref, so we don't
+    //       needlessly copy the chunk.
+    const Tile& currentTile{getTile(tileX, tileY)};
+    if ((currentTile.layerCount > layerIndex)
+        && (currentTile.spriteIDs[layerIndex] == numericID)) {
         return;
     }
 
+    Tile& tile{getMutableTile(tileX, tileY)};
+
     // If we're being asked to set the highest layer in the tile to the empty
     // sprite, erase it and any empties below it instead (to reduce space).
     std::size_t lowestDirtyLayer{0};
-    if ((sprite.numericID == EMPTY_SPRITE_ID)
-        && (layerIndex == (spriteLayers.size() - 1))) {
+    if ((numericID == EMPTY_SPRITE_ID)
+        && ((layerIndex + 1) == tile.layerCount)) {
         // Erase the sprite.
-        spriteLayers.erase(spriteLayers.begin() + layerIndex);
+        tile.layerCount--;
         lowestDirtyLayer = layerIndex;
 
-        // Erase any uncovered empty layers at the end of the vector.
-        for (std::size_t endIndex = layerIndex; endIndex-- > 0;) {
-            if (spriteLayers[endIndex].sprite.numericID == EMPTY_SPRITE_ID) {
-                spriteLayers.erase(spriteLayers.begin() + endIndex);
-                lowestDirtyLayer = endIndex;
-            }
-            else {
-                break;
-            }
+        // Erase any uncovered empty layers at the end of the array.
+        while ((tile.layerCount > 0)
+               && (tile.spriteIDs[tile.layerCount - 1] == EMPTY_SPRITE_ID)) {
+            tile.layerCount--;
+            lowestDirtyLayer = tile.layerCount;
         }
     }
     // Else, set the sprite layer.
     else {
-        // If the sprite has a bounding box, calculate its position.
-        BoundingBox worldBounds{};
-        if (sprite.hasBoundingBox) {
-            Position tilePosition{
-                static_cast<float>(tileX * SharedConfig::TILE_WORLD_WIDTH),
-                static_cast<float>(tileY * SharedConfig::TILE_WORLD_WIDTH), 0};
-            worldBounds
-                = Transforms::modelToWorld(sprite.modelBounds, tilePosition);
-        }
-
-        // If the tile's layers vector isn't big enough, resize it.
+        // If the tile doesn't have enough layers, add more.
         // Note: This sets intermediate layers to the empty sprite.
-        if (spriteLayers.size() <= layerIndex) {
-            spriteLayers.resize(
-                (layerIndex + 1),
-                {spriteData.get(EMPTY_SPRITE_ID), BoundingBox{}});
+        if (tile.layerCount <= layerIndex) {
+            for (std::size_t i = tile.layerCount; i < layerIndex; ++i) {
+                tile.spriteIDs[i] = EMPTY_SPRITE_ID;
+            }
+            tile.layerCount = static_cast<Uint8>(layerIndex + 1);
         }
 
         // Replace the sprite.
-        spriteLayers[layerIndex] = {sprite, worldBounds};
+        tile.spriteIDs[layerIndex] = numericID;
         lowestDirtyLayer = layerIndex;
     }
 
+    // Invalidate any data derived from this tile's chunk.
+    incrementChunkVersion(tileX, tileY);
+    updateTileCollision(tileX, tileY);
+
     // If we're tracking dirty tile state, update it.
     if (trackDirtyState) {
         // Set the lowest dirty layer index, unless there's already a lower
@@ -103,19 +115,6 @@ void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
     }
 }
 
-void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
-                                     std::size_t layerIndex,
-                                     const std::string& stringID)
-{
-    setTileSpriteLayer(tileX, tileY, layerIndex, spriteData.get(stringID));
-}
-
-void TileMapBase::setTileSpriteLayer(int tileX, int tileY,
-                                     std::size_t layerIndex, int numericID)
-{
-    setTileSpriteLayer(tileX, tileY, layerIndex, spriteData.get(numericID));
-}
-
 bool TileMapBase::clearTileSpriteLayers(int tileX, int tileY,
                                         std::size_t startLayerIndex,
                                         std::size_t endLayerIndex)
@@ -125,47 +124,46 @@ bool TileMapBase::clearTileSpriteLayers(int tileX, int tileY,
     AM_ASSERT(startLayerIndex <= endLayerIndex,
               "End layer index must be greater than start");
 
-    Tile& tile{tiles[linearizeTileIndex(tileX, tileY)]};
-    std::vector<Tile::SpriteLayer>& spriteLayers{tile.spriteLayers};
-
     // If the start index is beyond this tile's highest layer, return false.
-    if (startLayerIndex >= spriteLayers.size()) {
+    // Note: We only take a mutable tile once we know that it'll change,
+    //       since doing so may copy the chunk.
+    if (startLayerIndex >= getTile(tileX, tileY).layerCount) {
         return false;
     }
 
-    // If the end index is at the end of the vector (or beyond), erase
+    // If the end index is at the end of the array (or beyond), erase
     // the elements.
     std::size_t lowestDirtyLayer{startLayerIndex};
     bool layerWasCleared{false};
-    if (endLayerIndex >= (spriteLayers.size() - 1)) {
-        spriteLayers.erase((spriteLayers.begin() + startLayerIndex),
-                           spriteLayers.end());
-
-        // Erase any uncovered empty layers at the end of the vector.
-        for (std::size_t endIndex = startLayerIndex; endIndex-- > 0;) {
-            if (spriteLayers[endIndex].sprite.numericID == EMPTY_SPRITE_ID) {
-                spriteLayers.erase(spriteLayers.begin() + endIndex);
-                lowestDirtyLayer = endIndex;
-            }
-            else {
-                break;
-            }
+    if ((endLayerIndex + 1) >= getTile(tileX, tileY).layerCount) {
+        Tile& tile{getMutableTile(tileX, tileY)};
+        tile.layerCount = static_cast<Uint8>(startLayerIndex);
+
+        // Erase any uncovered empty layers at the end of the array.
+        while ((tile.layerCount > 0)
+               && (tile.spriteIDs[tile.layerCount - 1] == EMPTY_SPRITE_ID)) {
+            tile.layerCount--;
+            lowestDirtyLayer = tile.layerCount;
         }
 
         layerWasCleared = true;
+        incrementChunkVersion(tileX, tileY);
+        updateTileCollision(tileX, tileY);
     }
     else {
         // Else, set the elements to the empty sprite.
+        // Note: We re-get the tile each time, since setTileSpriteLayer()
+        //       may have copied its chunk.
         for (std::size_t i = startLayerIndex; i <= endLayerIndex; ++i) {
-            if (spriteLayers[i].sprite.numericID != EMPTY_SPRITE_ID) {
+            if (getTile(tileX, tileY).spriteIDs[i] != EMPTY_SPRITE_ID) {
                 setTileSpriteLayer(tileX, tileY, i, EMPTY_SPRITE_ID);
                 layerWasCleared = true;
             }
         }
     }
 
-    // If we're tracking dirty tile state, update it.
-    if (trackDirtyState) {
+    // If we're tracking dirty tile state and something changed, update it.
+    if (trackDirtyState && layerWasCleared) {
         // Set the lowest dirty layer index, unless there's already a lower
         // one being tracked.
         auto [iterator, didEmplace]
@@ -180,22 +178,24 @@ bool TileMapBase::clearTileSpriteLayers(int tileX, int tileY,
 
 bool TileMapBase::clearTile(int tileX, int tileY)
 {
-    Tile& tile{tiles[linearizeTileIndex(tileX, tileY)]};
+    // If the tile is already empty, return false.
+    if (getTile(tileX, tileY).layerCount == 0) {
+        return false;
+    }
 
-    bool layersWereCleared{false};
-    if (tile.spriteLayers.size() > 0) {
-        layersWereCleared = true;
-
-        // If we're tracking dirty tile state, update it.
-        if (trackDirtyState) {
-            // Set the lowest dirty layer index.
-            // Note: We don't have to check before setting, since 0 is lowest.
-            dirtyTiles[{tileX, tileY}] = 0;
-        }
+    // If we're tracking dirty tile state, update it.
+    if (trackDirtyState) {
+        // Set the lowest dirty layer index.
+        // Note: We don't have to check before setting, since 0 is lowest.
+        dirtyTiles[{tileX, tileY}] = 0;
     }
 
-    tile.spriteLayers.clear();
-    return layersWereCleared;
+    getMutableTile(tileX, tileY).layerCount = 0;
+
+    incrementChunkVersion(tileX, tileY);
+    updateTileCollision(tileX, tileY);
+
+    return true;
 }
 
 bool TileMapBase::clearExtentSpriteLayers(TileExtent extent,
@@ -237,7 +237,10 @@ void TileMapBase::clear()
 {
     chunkExtent = {};
     tileExtent = {};
-    tiles.clear();
+    chunks.clear();
+    chunkVersions.clear();
+    residentChunkCount = 0;
+    chunkCollisions.clear();
     dirtyTiles.clear();
 }
 
@@ -247,15 +250,42 @@ const Tile& TileMapBase::getTile(int x, int y) const
     AM_ASSERT(x >= 0, "Negative coords not yet supported");
     AM_ASSERT(y >= 0, "Negative coords not yet supported");
 
-    std::size_t tileIndex{linearizeTileIndex(x, y)};
-    std::size_t maxTileIndex{
-        static_cast<std::size_t>(tileExtent.xLength * tileExtent.yLength)};
-    AM_ASSERT((tileIndex < maxTileIndex),
-              "Tried to get an out of bounds tile. tileIndex: %u, max: %u",
-              tileIndex, maxTileIndex);
-    ignore(maxTileIndex);
+    std::size_t chunkIndex{linearizeChunkIndex(
+        (x / SharedConfig::CHUNK_WIDTH), (y / SharedConfig::CHUNK_WIDTH))};
+    AM_ASSERT((chunkIndex < chunks.size()),
+              "Tried to get an out of bounds tile. chunkIndex: %u, max: %u",
+              chunkIndex, chunks.size());
+
+    return chunks[chunkIndex]->tiles[linearizeChunkTileIndex(x, y)];
+}
+
+std::span<const BoundingBox> TileMapBase::getTileCollisionBoxes(int x,
+                                                                int y) const
+{
+    // If the tile's chunk has no collision, return early.
+    const ChunkCollision* chunkCollision{
+        chunkCollisions[linearizeChunkIndex((x / SharedConfig::CHUNK_WIDTH),
+                                            (y / SharedConfig::CHUNK_WIDTH))]
+            .get()};
+    if (chunkCollision == nullptr) {
+        return {};
+    }
+
+    // If the tile has no collision, return early.
+    std::size_t tileIndex{linearizeChunkTileIndex(x, y)};
+    if (!(chunkCollision->hasCollision[tileIndex])) {
+        return {};
+    }
 
-    return tiles[tileIndex];
+    // Return the tile's boxes.
+    std::size_t boxStart{chunkCollision->boxOffsets[tileIndex]};
+    std::size_t boxEnd{chunkCollision->boxOffsets[tileIndex + 1]};
+    return {(chunkCollision->boxes.data() + boxStart), (boxEnd - boxStart)};
+}
+
+const Sprite& TileMapBase::getSprite(int numericID) const
+{
+    return spriteData.get(numericID);
 }
 
 const ChunkExtent& TileMapBase::getChunkExtent() const
@@ -273,4 +303,237 @@ std::unordered_map<TilePosition, std::size_t>& TileMapBase::getDirtyTiles()
     return dirtyTiles;
 }
 
+Uint32 TileMapBase::getChunkVersion(const ChunkPosition& chunkPosition) const
+{
+    return chunkVersions[linearizeChunkIndex(chunkPosition.x,
+                                             chunkPosition.y)];
+}
+
+std::shared_ptr<const Chunk>
+    TileMapBase::getChunkSnapshot(const ChunkPosition& chunkPosition) const
+{
+    return chunks[linearizeChunkIndex(chunkPosition.x, chunkPosition.y)];
+}
+
+void TileMapBase::allocateChunks()
+{
+    std::size_t chunkCount{
+        static_cast<std::size_t>(chunkExtent.xLength * chunkExtent.yLength)};
+    chunks.assign(chunkCount, emptyChunk);
+    chunkVersions.assign(chunkCount, 0);
+    residentChunkCount = 0;
+
+    chunkCollisions.clear();
+    chunkCollisions.resize(chunkCount);
+}
+
+const Chunk& TileMapBase::getChunk(const ChunkPosition& chunkPosition) const
+{
+    return *(chunks[linearizeChunkIndex(chunkPosition.x, chunkPosition.y)]);
+}
+
+void TileMapBase::setChunk(const ChunkPosition& chunkPosition,
+                           const Chunk& chunk)
+{
+    // If the new chunk is empty, point it at the sentinel instead of
+    // allocating it.
+    if (isChunkEmpty(chunk)) {
+        releaseChunk(chunkPosition);
+    }
+    else {
+        getMutableChunk(chunkPosition) = chunk;
+        rebuildChunkCollision(chunkPosition);
+    }
+
+    // If we're tracking dirty tile state, mark every tile as dirty.
+    if (trackDirtyState) {
+        TilePosition startTile{chunkPosition};
+        for (int y = 0; y < static_cast<int>(SharedConfig::CHUNK_WIDTH); ++y) {
+            for (int x = 0; x < static_cast<int>(SharedConfig::CHUNK_WIDTH);
+                 ++x) {
+                dirtyTiles[{(startTile.x + x), (startTile.y + y)}] = 0;
+            }
+        }
+    }
+}
+
+bool TileMapBase::isChunkResident(const ChunkPosition& chunkPosition) const
+{
+    return (chunks[linearizeChunkIndex(chunkPosition.x, chunkPosition.y)]
+            != emptyChunk);
+}
+
+std::size_t TileMapBase::getResidentChunkCount() const
+{
+    return residentChunkCount;
+}
+
+void TileMapBase::releaseChunk(const ChunkPosition& chunkPosition)
+{
+    std::size_t chunkIndex{
+        linearizeChunkIndex(chunkPosition.x, chunkPosition.y)};
+    std::shared_ptr<Chunk>& chunk{chunks[chunkIndex]};
+    if (chunk != emptyChunk) {
+        // Note: If someone is holding a snapshot of this chunk, it'll stay
+        //       alive until they're done with it.
+        chunk = emptyChunk;
+        chunkVersions[chunkIndex]++;
+        residentChunkCount--;
+        chunkCollisions[chunkIndex] = nullptr;
+    }
+}
+
+Chunk& TileMapBase::getMutableChunk(const ChunkPosition& chunkPosition)
+{
+    std::size_t chunkIndex{
+        linearizeChunkIndex(chunkPosition.x, chunkPosition.y)};
+    chunkVersions[chunkIndex]++;
+    return copyChunkIfShared(chunks[chunkIndex]);
+}
+
+void TileMapBase::rebuildChunkCollision(const ChunkPosition& chunkPosition)
+{
+    std::size_t chunkIndex{
+        linearizeChunkIndex(chunkPosition.x, chunkPosition.y)};
+    const Chunk& chunk{*(chunks[chunkIndex])};
+
+    // Gather the collision boxes of each tile in the chunk.
+    auto chunkCollision{std::make_unique<ChunkCollision>()};
+    std::vector<BoundingBox>& boxes{chunkCollision->boxes};
+    TilePosition startTile{chunkPosition};
+    std::array<BoundingBox, SharedConfig::MAX_TILE_LAYERS> tileBoxes{};
+    for (std::size_t i = 0; i < SharedConfig::CHUNK_TILE_COUNT; ++i) {
+        int tileX{startTile.x
+                  + static_cast<int>(i % SharedConfig::CHUNK_WIDTH)};
+        int tileY{startTile.y
+                  + static_cast<int>(i / SharedConfig::CHUNK_WIDTH)};
+        std::size_t boxCount{
+            buildTileCollisionBoxes(tileX, tileY, chunk.tiles[i], tileBoxes)};
+
+        chunkCollision->boxOffsets[i] = static_cast<Uint16>(boxes.size());
+        chunkCollision->hasCollision[i] = (boxCount > 0);
+        boxes.insert(boxes.end(), tileBoxes.begin(),
+                     (tileBoxes.begin() + boxCount));
+    }
+    chunkCollision->boxOffsets[SharedConfig::CHUNK_TILE_COUNT]
+        = static_cast<Uint16>(boxes.size());
+
+    // If the chunk has no collision, don't bother keeping the data.
+    if (boxes.size() == 0) {
+        chunkCollisions[chunkIndex] = nullptr;
+    }
+    else {
+        chunkCollisions[chunkIndex] = std::move(chunkCollision);
+    }
+}
+
+Tile& TileMapBase::getMutableTile(int x, int y)
+{
+    AM_ASSERT(x >= 0, "Negative coords not yet supported");
+    AM_ASSERT(y >= 0, "Negative coords not yet supported");
+
+    std::shared_ptr<Chunk>& chunk{chunks[linearizeChunkIndex(
+        (x / SharedConfig::CHUNK_WIDTH), (y / SharedConfig::CHUNK_WIDTH))]};
+    return copyChunkIfShared(chunk).tiles[linearizeChunkTileIndex(x, y)];
+}
+
+Chunk& TileMapBase::copyChunkIfShared(std::shared_ptr<Chunk>& chunk)
+{
+    // If this chunk is the empty sentinel, give it its own tile data.
+    if (chunk == emptyChunk) {
+        chunk = std::make_shared<Chunk>();
+        residentChunkCount++;
+    }
+    // If someone else is holding a snapshot of this chunk, copy it so that
+    // their snapshot doesn't change.
+    // Note: Snapshots are only created on this thread, so the use count can
+    //       only be stale-high (causing an unnecessary copy), never
+    //       stale-low. The fence pairs with the release in the other
+    //       thread's decrement, so its reads finish before we write.
+    else if (chunk.use_count() > 1) {
+        chunk = std::make_shared<Chunk>(*chunk);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return *chunk;
+}
+
+void TileMapBase::incrementChunkVersion(int tileX, int tileY)
+{
+    ChunkPosition chunkPosition{TilePosition{tileX, tileY}};
+    chunkVersions[linearizeChunkIndex(chunkPosition.x, chunkPosition.y)]++;
+}
+
+void TileMapBase::updateTileCollision(int tileX, int tileY)
+{
+    // Gather the tile's new collision boxes.
+    std::array<BoundingBox, SharedConfig::MAX_TILE_LAYERS> tileBoxes{};
+    std::size_t newBoxCount{buildTileCollisionBoxes(
+        tileX, tileY, getTile(tileX, tileY), tileBoxes)};
+
+    // If the chunk has no collision and still doesn't need any, exit early.
+    std::unique_ptr<ChunkCollision>& chunkCollision{
+        chunkCollisions[linearizeChunkIndex(
+            (tileX / SharedConfig::CHUNK_WIDTH),
+            (tileY / SharedConfig::CHUNK_WIDTH))]};
+    if (chunkCollision == nullptr) {
+        if (newBoxCount == 0) {
+            return;
+        }
+        chunkCollision = std::make_unique<ChunkCollision>();
+    }
+
+    // Replace the tile's old boxes with the new ones.
+    std::vector<BoundingBox>& boxes{chunkCollision->boxes};
+    auto& boxOffsets{chunkCollision->boxOffsets};
+    std::size_t tileIndex{linearizeChunkTileIndex(tileX, tileY)};
+    std::size_t boxStart{boxOffsets[tileIndex]};
+    std::size_t oldBoxCount{boxOffsets[tileIndex + 1] - boxStart};
+    boxes.erase((boxes.begin() + boxStart),
+                (boxes.begin() + boxStart + oldBoxCount));
+    boxes.insert((boxes.begin() + boxStart), tileBoxes.begin(),
+                 (tileBoxes.begin() + newBoxCount));
+    chunkCollision->hasCollision[tileIndex] = (newBoxCount > 0);
+
+    // Shift the following tiles' offsets to account for the change.
+    for (std::size_t i = (tileIndex + 1); i < boxOffsets.size(); ++i) {
+        boxOffsets[i]
+            = static_cast<Uint16>((boxOffsets[i] + newBoxCount) - oldBoxCount);
+    }
+
+    // If the chunk no longer has any collision, free its data.
+    if (boxes.size() == 0) {
+        chunkCollision = nullptr;
+    }
+}
+
+std::size_t TileMapBase::buildTileCollisionBoxes(
+    int tileX, int tileY, const Tile& tile,
+    std::array<BoundingBox, SharedConfig::MAX_TILE_LAYERS>& tileBoxes) const
+{
+    std::size_t boxCount{0};
+    for (std::size_t i = 0; i < tile.layerCount; ++i) {
+        // If this layer doesn't have a bounding box, skip it.
+        int spriteID{tile.spriteIDs[i]};
+        if (spriteID == EMPTY_SPRITE_ID) {
+            continue;
+        }
+        const Sprite& sprite{spriteData.get(spriteID)};
+        if (!(sprite.hasBoundingBox)) {
+            continue;
+        }
+
+        tileBoxes[boxCount++]
+            = Transforms::modelToWorldTile(sprite.modelBounds, {tileX, tileY});
+    }
+
+    return boxCount;
+}
+
+bool TileMapBase::isChunkEmpty(const Chunk& chunk)
+{
+    return std::all_of(chunk.tiles.begin(), chunk.tiles.end(),
+                       [](const Tile& tile) { return (tile.layerCount == 0); });
+}
+
 } // End namespace AM
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace AM
+{
+/**
+ * Flags that an entity's movement needs to be processed.
+ *
+ * Movement systems only process entities that have this component. It's
+ * added when an entity's inputs change, and removed once the entity has no
+ * inputs pressed and has come to rest. This way, idle entities cost nothing
+ * per tick.
+ */
+struct IsMoving {
+};
+
+} // End namespace AM
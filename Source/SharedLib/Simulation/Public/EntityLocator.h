@@ -61,6 +61,16 @@ public:
     std::vector<entt::entity>& getEntitiesCoarse(const Position& cylinderCenter,
                                                  unsigned int radius);
 
+    /**
+     * Overload that fills the given vector instead of our return vector.
+     *
+     * Note: Since this doesn't modify the locator, it's safe to call from
+     *       multiple threads at once, as long as nothing is updating the
+     *       locator.
+     */
+    void getEntitiesCoarse(const Position& cylinderCenter, unsigned int radius,
+                           std::vector<entt::entity>& outEntities) const;
+
     /**
      * Overload for BoundingBox.
      */
@@ -88,6 +98,16 @@ public:
     std::vector<entt::entity>& getEntitiesFine(const Position& cylinderCenter,
                                                unsigned int radius);
 
+    /**
+     * Overload that fills the given vector instead of our return vector.
+     *
+     * Note: This only reads the locator and the registry's Collision
+     *       components, so it's safe to call from multiple threads at once,
+     *       as long as nothing is updating them.
+     */
+    void getEntitiesFine(const Position& cylinderCenter, unsigned int radius,
+                         std::vector<entt::entity>& outEntities) const;
+
     /**
      * Overload for BoundingBox.
      */
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Input.h"
+#include "Position.h"
+#include "Velocity.h"
+#include "Rotation.h"
+#include "entt/entity/entity.hpp"
+#include <vector>
+#include <cstddef>
+
+namespace AM
+{
+/**
+ * The movement state of a batch of entities, stored as a structure of arrays.
+ *
+ * Movement systems gather their moving entities into a batch, integrate it
+ * with MovementHelpers::updateBatch(), then write the results back. Keeping
+ * each field contiguous lets the integration loop be vectorized.
+ *
+ * All vectors are index-aligned. Systems should keep a batch around and
+ * clear() it each tick, so its allocations get re-used.
+ */
+struct MovementBatch {
+public:
+    /** The entity that each element belongs to. */
+    std::vector<entt::entity> entities{};
+
+    /** The X direction input. 1 == XUp, -1 == XDown, 0 == none or
+        canceling. */
+    std::vector<int> xInputs{};
+    /** The Y direction input. 1 == YUp, -1 == YDown, 0 == none or
+        canceling. */
+    std::vector<int> yInputs{};
+
+    std::vector<float> velocityXs{};
+    std::vector<float> velocityYs{};
+
+    std::vector<float> positionXs{};
+    std::vector<float> positionYs{};
+
+    /** The Rotation::Direction of each entity, widened to match the other
+        fields. */
+    std::vector<int> directions{};
+
+    /**
+     * Adds the given entity's movement state to the end of the batch.
+     */
+    void push(entt::entity entity, const Input& input,
+              const Position& position, const Velocity& velocity,
+              const Rotation& rotation)
+    {
+        entities.push_back(entity);
+        xInputs.push_back(static_cast<int>(input.inputStates[Input::XUp])
+                          - static_cast<int>(input.inputStates[Input::XDown]));
+        yInputs.push_back(static_cast<int>(input.inputStates[Input::YUp])
+                          - static_cast<int>(input.inputStates[Input::YDown]));
+        velocityXs.push_back(velocity.x);
+        velocityYs.push_back(velocity.y);
+        positionXs.push_back(position.x);
+        positionYs.push_back(position.y);
+        directions.push_back(static_cast<int>(rotation.direction));
+    }
+
+    /**
+     * Removes all elements, keeping the allocated capacity.
+     */
+    void clear()
+    {
+        entities.clear();
+        xInputs.clear();
+        yInputs.clear();
+        velocityXs.clear();
+        velocityYs.clear();
+        positionXs.clear();
+        positionYs.clear();
+        directions.clear();
+    }
+
+    std::size_t size() const { return entities.size(); }
+};
+
+} // End namespace AM
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Tile.h"
+#include "SharedConfig.h"
+#include <array>
+
+namespace AM
+{
+/**
+ * A 16x16 block of tiles in the tile map.
+ *
+ * TileMapBase holds its chunks through shared pointers. Other threads may
+ * hold a pointer to a chunk as an immutable snapshot. If the map needs to
+ * modify a chunk while a snapshot of it is held, it first makes a copy (see
+ * TileMapBase::getChunkSnapshot()).
+ *
+ * Chunks that have never been modified all share a single empty chunk, so
+ * they don't cost any tile memory.
+ */
+struct Chunk {
+public:
+    /** The tiles that make up this chunk, stored in row-major order. */
+    std::array<Tile, SharedConfig::CHUNK_TILE_COUNT> tiles{};
+};
+
+} // End namespace AM
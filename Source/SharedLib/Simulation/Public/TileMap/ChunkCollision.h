@@ -0,0 +1,35 @@
+#pragma once
+
+#include "BoundingBox.h"
+#include "SharedConfig.h"
+#include <SDL_stdinc.h>
+#include <bitset>
+#include <array>
+#include <vector>
+
+namespace AM
+{
+/**
+ * The static collision data for a 16x16 chunk of tiles.
+ *
+ * Derived from the chunk's tile layers, and kept in sync by TileMapBase
+ * whenever they change. Collision checks can skip a tile with a single bit
+ * test, and only read the boxes of tiles that actually have collision.
+ */
+struct ChunkCollision {
+public:
+    /** If a tile's bit is set, it has at least 1 collision box.
+        Indexed the same as Chunk::tiles. */
+    std::bitset<SharedConfig::CHUNK_TILE_COUNT> hasCollision{};
+
+    /** The index in boxes where each tile's collision boxes start.
+        A tile's boxes end where the next tile's begin, so there's an extra
+        element at the end. */
+    std::array<Uint16, SharedConfig::CHUNK_TILE_COUNT + 1> boxOffsets{};
+
+    /** The world-space collision boxes of every tile in this chunk, packed
+        in the same order as Chunk::tiles. */
+    std::vector<BoundingBox> boxes{};
+};
+
+} // End namespace AM
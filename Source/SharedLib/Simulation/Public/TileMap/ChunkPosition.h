@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DiscretePosition.h"
+#include "HashTools.h"
 
 namespace AM
 {
@@ -27,3 +28,20 @@ void serialize(S& serializer, ChunkPosition& chunkPosition)
 }
 
 } // namespace AM
+
+// std::hash() specialization.
+namespace std
+{
+template<>
+struct hash<AM::ChunkPosition> {
+    typedef AM::ChunkPosition argument_type;
+    typedef std::size_t result_type;
+    result_type operator()(const argument_type& position) const
+    {
+        std::size_t seed{0};
+        AM::hash_combine(seed, position.x);
+        AM::hash_combine(seed, position.y);
+        return seed;
+    }
+};
+} // namespace std
@@ -1,8 +1,8 @@
 #pragma once
 
-#include "Sprite.h"
-#include "BoundingBox.h"
-#include <vector>
+#include "SharedConfig.h"
+#include <SDL_stdinc.h>
+#include <array>
 
 namespace AM
 {
@@ -12,31 +12,26 @@ namespace AM
  * A tile consists of layers of sprites, which can be floors, grass, walls,
  * etc.
  *
+ * Layers are stored inline as numeric sprite IDs. To get a layer's sprite
+ * data, look it up in SpriteData. Tiles don't move, so a layer's world bounds
+ * can be derived from its sprite's modelBounds and the tile's position (see
+ * Transforms::modelToWorldTile()).
+ *
  * Tiles contain no logic. If something on a tile requires logic, e.g. a tree
  * growing over time, it must have a system act upon it.
  */
 struct Tile {
 public:
-    /**
-     * Represents a sprite, placed on one of a tile's layers.
-     */
-    struct SpriteLayer {
-        /** The sprite that this layer contains. */
-        Sprite sprite{};
-
-        /** If sprite.hasBoundingBox == true, this is the sprite's modelBounds
-            moved to match the tile's world position.
-            Tiles don't move, so we can calculate this ahead of time and save
-            it here. */
-        BoundingBox worldBounds{};
-    };
-
-    /** The layers of sprites that make up this tile, ordered bottom to top.
+    /** The numeric IDs of the sprites that make up this tile, ordered bottom
+        to top. Only the first layerCount elements are valid.
 
         Sprites with bounding boxes will be rendered in an order corresponding
         to their box extent, but sprites with no box will be rendered by order
-        of appearance in this vector, from begin -> end. */
-    std::vector<SpriteLayer> spriteLayers{};
+        of appearance in this array, from begin -> end. */
+    std::array<int, SharedConfig::MAX_TILE_LAYERS> spriteIDs{};
+
+    /** The number of layers in spriteIDs that are in use. */
+    Uint8 layerCount{0};
 };
 
 } // End namespace AM
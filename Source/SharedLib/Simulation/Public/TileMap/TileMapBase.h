@@ -1,9 +1,16 @@
 #pragma once
 
 #include "Tile.h"
+#include "Chunk.h"
+#include "ChunkCollision.h"
+#include "Sprite.h"
 #include "ChunkExtent.h"
 #include "TileExtent.h"
+#include "ChunkPosition.h"
+#include <SDL_stdinc.h>
+#include <memory>
 #include <vector>
+#include <span>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -16,6 +23,13 @@ class SpriteDataBase;
  * Owns and manages the world's tile map state.
  * Tiles are conceptually organized into 16x16 chunks.
  *
+ * Chunks are allocated lazily. Until a chunk's tiles are first modified, it
+ * points at a shared, all-empty sentinel chunk, so large mostly-empty maps
+ * only pay for the chunks that have content.
+ *
+ * Each chunk's static collision boxes are derived from its tiles and kept up
+ * to date as tiles change (see getTileCollisionBoxes()).
+ *
  * Persisted tile map data is loaded from TileMap.bin.
  */
 class TileMapBase
@@ -31,9 +45,8 @@ public:
     /**
      * Sets the layer at the given index to the given sprite.
      *
-     * If the given tile's spriteLayers vector isn't big enough, resizes
-     * it. Any tiles added during resizing will be default initialized to
-     * the "empty sprite".
+     * If the given tile doesn't have enough layers, adds more. Any layers
+     * added this way will be set to the "empty sprite".
      *
      * Note: There's no bounds checking on tileX/tileY. It's on you to make
      *       sure they're valid.
@@ -59,11 +72,11 @@ public:
      *
      * It's valid to use the same index as the start and end.
      *
-     * It's safe to use an end index that's past the end of the tile's vector,
+     * It's safe to use an end index that's past the end of the tile's layers,
      * it will be constrained.
      *
-     * If clearing to the end of the vector, layers will be erased. Otherwise,
-     * they'll be set to the "empty sprite".
+     * If clearing to the end of the tile's layers, layers will be erased.
+     * Otherwise, they'll be set to the "empty sprite".
      *
      * @param startLayerIndex  The layer index to start clearing at.
      * @param endLayerIndex  The last layer index to clear. Must be >= start.
@@ -112,6 +125,21 @@ public:
      */
     const Tile& getTile(int x, int y) const;
 
+    /**
+     * Returns the world-space collision boxes of the tile at the given
+     * coordinates. If the tile has no collision, the span will be empty.
+     *
+     * Note: There's no bounds checking on x/y. It's on you to make sure
+     *       they're valid.
+     */
+    std::span<const BoundingBox> getTileCollisionBoxes(int x, int y) const;
+
+    /**
+     * Returns the sprite with the given numeric ID.
+     * Used to get the sprite data for a tile's layers.
+     */
+    const Sprite& getSprite(int numericID) const;
+
     /**
      * Returns the map extent, with chunks as the unit.
      */
@@ -131,19 +159,135 @@ public:
      */
     std::unordered_map<TilePosition, std::size_t>& getDirtyTiles();
 
+    /**
+     * Returns the given chunk's version number.
+     *
+     * A chunk's version is incremented whenever any of its tiles are changed,
+     * so it can be used to tell if data derived from the chunk is stale.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    Uint32 getChunkVersion(const ChunkPosition& chunkPosition) const;
+
+    /**
+     * Returns an immutable snapshot of the given chunk.
+     *
+     * The snapshot is safe to read from other threads. Any later changes to
+     * the chunk will copy it first, leaving the snapshot untouched.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    std::shared_ptr<const Chunk>
+        getChunkSnapshot(const ChunkPosition& chunkPosition) const;
+
+    /**
+     * Gets a const reference to the chunk at the given coordinates.
+     *
+     * Walking a chunk's tiles array is faster than calling getTile() for
+     * each tile, since the tiles are contiguous.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    const Chunk& getChunk(const ChunkPosition& chunkPosition) const;
+
+    /**
+     * Replaces all of the tiles in the chunk at the given coordinates.
+     *
+     * If we're tracking dirty state, every tile in the chunk will be marked
+     * as dirty.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    void setChunk(const ChunkPosition& chunkPosition, const Chunk& chunk);
+
+    /**
+     * Returns true if the chunk at the given coordinates has its own tile
+     * data allocated. Returns false if it's sharing the empty sentinel chunk.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    bool isChunkResident(const ChunkPosition& chunkPosition) const;
+
+    /**
+     * Returns the number of chunks that have their own tile data allocated.
+     */
+    std::size_t getResidentChunkCount() const;
+
+    /**
+     * Frees the tile data of the chunk at the given coordinates, leaving it
+     * empty.
+     *
+     * This is meant for dropping data that can be re-fetched later (e.g. a
+     * client evicting far-away chunks), so the chunk's tiles aren't marked
+     * as dirty.
+     *
+     * Note: There's no bounds checking on chunkPosition. It's on you to make
+     *       sure it's valid.
+     */
+    void releaseChunk(const ChunkPosition& chunkPosition);
+
 protected:
     /**
-     * Returns the index in the tiles vector where the tile with the given
+     * Returns the index in the chunks vector where the chunk with the given
      * coordinates can be found.
      */
-    inline std::size_t linearizeTileIndex(int x, int y) const
+    inline std::size_t linearizeChunkIndex(int x, int y) const
+    {
+        return static_cast<std::size_t>((y * chunkExtent.xLength) + x);
+    }
+
+    /**
+     * Returns the index within its chunk's tiles array where the tile with
+     * the given coordinates can be found.
+     */
+    inline std::size_t linearizeChunkTileIndex(int x, int y) const
     {
-        return static_cast<std::size_t>((y * tileExtent.xLength) + x);
+        return static_cast<std::size_t>(
+            ((y % SharedConfig::CHUNK_WIDTH) * SharedConfig::CHUNK_WIDTH)
+            + (x % SharedConfig::CHUNK_WIDTH));
     }
 
+    /**
+     * Fills chunkExtent with empty chunks, and resets their versions.
+     * Must be called after chunkExtent is set.
+     *
+     * Note: The chunks all share the empty sentinel chunk. Their tile data is
+     *       allocated when they're first modified.
+     */
+    void allocateChunks();
+
+    /**
+     * Returns a mutable reference to the chunk at the given coordinates, and
+     * increments its version.
+     *
+     * If a snapshot of the chunk is being held (or the chunk is still the
+     * empty sentinel), copies the chunk first.
+     *
+     * Note: When you're done modifying the chunk, you must call
+     *       rebuildChunkCollision().
+     */
+    Chunk& getMutableChunk(const ChunkPosition& chunkPosition);
+
+    /**
+     * Rebuilds the collision data for the chunk at the given coordinates
+     * from its tiles.
+     *
+     * Note: This only touches the given chunk's data, so different chunks
+     *       can be rebuilt in parallel.
+     */
+    void rebuildChunkCollision(const ChunkPosition& chunkPosition);
+
     /** The version of the map format. Kept as just a 16-bit int for now, we
-        can see later if we care to make it more complicated. */
-    static constexpr uint16_t MAP_FORMAT_VERSION = 0;
+        can see later if we care to make it more complicated.
+        Version 0: A bitsery-serialized TileMapSnapshot.
+        Version 1: An indexed file with LZ4-compressed chunks (see
+                   Server::TileMap). */
+    static constexpr uint16_t MAP_FORMAT_VERSION = 1;
 
     /** Used to get sprites while constructing tiles. */
     SpriteDataBase& spriteData;
@@ -154,10 +298,72 @@ protected:
     /** The map's extent, with tiles as the unit. */
     TileExtent tileExtent;
 
-    /** The tiles that make up this map, stored in row-major order. */
-    std::vector<Tile> tiles;
+    /** The chunks that make up this map, stored in row-major order. */
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+    /** The version number of each chunk in this map, stored in row-major
+        order. */
+    std::vector<Uint32> chunkVersions;
+
+    /** The chunk that all non-resident chunks point to.
+        Never modified, since it's always shared. */
+    const std::shared_ptr<Chunk> emptyChunk;
+
+    /** The number of elements in chunks that don't point to emptyChunk. */
+    std::size_t residentChunkCount;
+
+    /** The static collision data for each chunk in this map, stored in
+        row-major order. nullptr if the chunk has no collision. */
+    std::vector<std::unique_ptr<ChunkCollision>> chunkCollisions;
 
 private:
+    /**
+     * Returns a mutable reference to the tile at the given coordinates.
+     *
+     * If a snapshot of the tile's chunk is being held, copies the chunk
+     * first.
+     * Note: Unlike getMutableChunk(), this doesn't increment the chunk's
+     *       version.
+     */
+    Tile& getMutableTile(int x, int y);
+
+    /**
+     * If a snapshot of the given chunk is being held, replaces it with a
+     * copy.
+     * If the given chunk is the empty sentinel, this is where it first gets
+     * its own tile data.
+     *
+     * @return A mutable reference to the (possibly new) chunk.
+     */
+    Chunk& copyChunkIfShared(std::shared_ptr<Chunk>& chunk);
+
+    /**
+     * Increments the version of the chunk that contains the given tile.
+     */
+    void incrementChunkVersion(int tileX, int tileY);
+
+    /**
+     * Re-derives the collision boxes for the tile at the given coordinates.
+     * Must be called after the tile's layers are changed.
+     */
+    void updateTileCollision(int tileX, int tileY);
+
+    /**
+     * Fills tileBoxes with the world-space collision boxes of the given
+     * tile's layers.
+     *
+     * @return The number of boxes that were added to tileBoxes.
+     */
+    std::size_t buildTileCollisionBoxes(
+        int tileX, int tileY, const Tile& tile,
+        std::array<BoundingBox, SharedConfig::MAX_TILE_LAYERS>& tileBoxes)
+        const;
+
+    /**
+     * Returns true if the given chunk has no layers in any of its tiles.
+     */
+    static bool isChunkEmpty(const Chunk& chunk);
+
     /** If true, any updates to a tile's state will cause that tile to be
         pushed into dirtyTiles. */
     bool trackDirtyState;
@@ -1,6 +1,9 @@
 #include "Log.h"
+#include "LogWriter.h"
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
+#include <algorithm>
 
 namespace AM
 {
@@ -8,6 +11,81 @@ const std::atomic<Uint32>* Log::currentTickPtr = nullptr;
 std::atomic<bool> Log::tickPtrIsRegistered = false;
 FILE* logFilePtr = nullptr;
 
+/**
+ * Returns the writer that all log lines go through.
+ *
+ * Note: The writer is never destroyed, since threads may still log while
+ *       the program is exiting. Instead, it's shut down at exit, which
+ *       writes any queued lines and switches it to synchronous writes.
+ */
+static LogWriter& getLogWriter()
+{
+    static LogWriter* logWriter{[]() {
+        LogWriter* writer{new LogWriter()};
+        std::atexit([]() { getLogWriter().shutdown(); });
+        return writer;
+    }()};
+    return *logWriter;
+}
+
+/**
+ * Appends the formatted expression to the given line, after the given
+ * number of already-written characters. Returns the new length of the line.
+ */
+static std::size_t appendFormatted(char* line, std::size_t length,
+                                   const char* expression, std::va_list arg)
+{
+    if (length >= LogWriter::MAX_LINE_LENGTH) {
+        return (LogWriter::MAX_LINE_LENGTH - 1);
+    }
+
+    int result{std::vsnprintf((line + length),
+                              (LogWriter::MAX_LINE_LENGTH - length),
+                              expression, arg)};
+    if (result > 0) {
+        length += static_cast<std::size_t>(result);
+    }
+    return std::min(length, (LogWriter::MAX_LINE_LENGTH - 1));
+}
+
+/**
+ * Calls appendFormatted() with the given variadic args.
+ */
+static std::size_t appendFormattedArgs(char* line, std::size_t length,
+                                       const char* expression, ...)
+{
+    std::va_list arg;
+    va_start(arg, expression);
+    length = appendFormatted(line, length, expression, arg);
+    va_end(arg);
+    return length;
+}
+
+/**
+ * Formats the given info into a line and queues it to be written.
+ *
+ * @param suppressedCount  If non-zero, a note is appended saying that this
+ *                         many similar lines were suppressed.
+ */
+static void writeInfo(Uint32 currentTick, unsigned int suppressedCount,
+                      const char* expression, std::va_list arg)
+{
+    // Format the line.
+    char line[LogWriter::MAX_LINE_LENGTH];
+    std::size_t length{appendFormattedArgs(line, 0, "Tick %u: ", currentTick)};
+    length = appendFormatted(line, length, expression, arg);
+
+    // If we suppressed any lines from this call site, say so.
+    if (suppressedCount > 0) {
+        length = appendFormattedArgs(line, length,
+                                     " (suppressed %u similar lines)",
+                                     suppressedCount);
+    }
+
+    // Queue the line to be written.
+    getLogWriter().write(line, length);
+}
+
 void Log::registerCurrentTickPtr(const std::atomic<Uint32>* inCurrentTickPtr)
 {
     currentTickPtr = inCurrentTickPtr;
@@ -22,30 +100,29 @@ void Log::info(const char* expression, ...)
         currentTick = *currentTickPtr;
     }
 
-    // Get the va_list into arg.
     std::va_list arg;
     va_start(arg, expression);
+    writeInfo(currentTick, 0, expression, arg);
+    va_end(arg);
+}
 
-    // If enabled, write to file.
-    if (logFilePtr != nullptr) {
-        // Copy the va_list since it's undefined to use it twice.
-        std::va_list argCopy;
-        va_copy(argCopy, arg);
-
-        std::fprintf(logFilePtr, "Tick %u: ", currentTick);
-        std::vfprintf(logFilePtr, expression, argCopy);
-        std::fprintf(logFilePtr, "\n");
-        std::fflush(logFilePtr);
-
-        va_end(argCopy);
+void Log::infoRateLimited(const char* expression, ...)
+{
+    // If this call site has been logging too often, skip it.
+    unsigned int suppressedCount{0};
+    if (!(getLogWriter().checkRateLimit(expression, suppressedCount))) {
+        return;
     }
 
-    // Write to stdout.
-    std::printf("Tick %u: ", currentTick);
-    std::vprintf(expression, arg);
-    std::printf("\n");
-    std::fflush(stdout);
+    // If the app hasn't registered a tick count, default to 0.
+    Uint32 currentTick = 0;
+    if (tickPtrIsRegistered) {
+        currentTick = *currentTickPtr;
+    }
 
+    std::va_list arg;
+    va_start(arg, expression);
+    writeInfo(currentTick, suppressedCount, expression, arg);
     va_end(arg);
 }
 
@@ -57,34 +134,26 @@ void Log::error(const char* fileName, int line, const char* expression, ...)
         currentTick = *currentTickPtr;
     }
 
-    // Get the va_list into arg.
+    // Wait for any lines that this thread already queued, so they're
+    // written before the error.
+    LogWriter& logWriter{getLogWriter()};
+    logWriter.flush();
+
+    // Format and write the lines.
+    // Note: Errors bypass the ring, so they can't be dropped if it's full,
+    //       and they're written before we return in case we're about to
+    //       abort.
+    char errorLine[LogWriter::MAX_LINE_LENGTH];
+    std::size_t length{appendFormattedArgs(
+        errorLine, 0, "Error at file: %s, line: %d, during tick: %u",
+        fileName, line, currentTick)};
+    logWriter.writeSynchronously(errorLine, length);
+
     std::va_list arg;
     va_start(arg, expression);
-
-    // If enabled, write to file.
-    if (logFilePtr != nullptr) {
-        // Copy the va_list since it's undefined to use it twice.
-        std::va_list argCopy;
-        va_copy(argCopy, arg);
-
-        std::fprintf(logFilePtr,
-                     "Error at file: %s, line: %d, during tick: %u\n", fileName,
-                     line, currentTick);
-        std::vfprintf(logFilePtr, expression, argCopy);
-        std::fprintf(logFilePtr, "\n");
-        std::fflush(logFilePtr);
-
-        va_end(argCopy);
-    }
-
-    // Write to stdout.
-    std::printf("Error at file: %s, line: %d, during tick: %u\n", fileName,
-                line, currentTick);
-    std::vprintf(expression, arg);
-    std::printf("\n");
-    std::fflush(stdout);
-
+    length = appendFormatted(errorLine, 0, expression, arg);
     va_end(arg);
+    logWriter.writeSynchronously(errorLine, length);
 }
 
 void Log::enableFileLogging(const std::string& fileName)
@@ -94,6 +163,8 @@ void Log::enableFileLogging(const std::string& fileName)
     if (logFilePtr == nullptr) {
         std::printf("Failed to open log file for writing.\n");
     }
+
+    getLogWriter().setLogFile(logFilePtr);
 }
 
 } // namespace AM
@@ -0,0 +1,297 @@
+#include "LogWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+namespace AM
+{
+thread_local LogWriter::ThreadState LogWriter::threadState;
+
+LogWriter::ThreadState::~ThreadState()
+{
+    // Release our ring so that a future thread can reuse it.
+    // Note: Any lines still in it will still be written.
+    if (ring != nullptr) {
+        ring->inUse.store(false, std::memory_order_release);
+    }
+}
+
+LogWriter::LogWriter()
+: rings{}
+, ringCount{0}
+, ringCreationMutex{}
+, writeMutex{}
+, wakeMutex{}
+, wakeCondition{}
+, droppedCount{0}
+, logFile{nullptr}
+, isRunning{true}
+, exitRequested{false}
+, writerThreadObj{}
+{
+    writerThreadObj = std::jthread(&LogWriter::writerLoop, this);
+}
+
+LogWriter::~LogWriter()
+{
+    shutdown();
+    for (std::size_t i = 0; i < ringCount; ++i) {
+        delete rings[i].load();
+    }
+}
+
+void LogWriter::write(const char* line, std::size_t length)
+{
+    length = std::min(length, (MAX_LINE_LENGTH - 1));
+
+    // If the writer thread isn't running or we couldn't get a ring, write
+    // the line ourselves.
+    Ring* ring{isRunning ? getThreadRing() : nullptr};
+    if (ring == nullptr) {
+        writeSynchronously(line, length);
+        return;
+    }
+
+    // If the ring is full, drop the line.
+    std::size_t head{ring->head.load(std::memory_order_relaxed)};
+    std::size_t tail{ring->tail.load(std::memory_order_acquire)};
+    if ((head - tail) >= RING_SIZE) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Copy the line into the ring and publish it.
+    // Note: The head store and the loads below are seq_cst, pairing with
+    //       the writer thread's tail store and head loads. This guarantees
+    //       that either the writer sees our line before it waits, or we see
+    //       that it emptied the ring and wake it.
+    Line& ringLine{ring->lines[head % RING_SIZE]};
+    std::memcpy(ringLine.text.data(), line, length);
+    ringLine.length = length;
+    ring->head.store((head + 1));
+
+    // If the ring was empty, the writer thread may be waiting. Wake it.
+    if (ring->tail.load() == head) {
+        wakeWriter();
+    }
+
+    // If we were shut down while pushing, the final drain may have missed
+    // our line. Drain it ourselves.
+    if (!isRunning) {
+        drainRings();
+    }
+}
+
+void LogWriter::flush()
+{
+    Ring* ring{threadState.ring};
+    if (ring == nullptr) {
+        // We've never pushed anything, so there's nothing to wait for.
+        return;
+    }
+
+    // Wait for the writer thread to write everything we've pushed.
+    std::size_t head{ring->head.load(std::memory_order_relaxed)};
+    auto deadline{std::chrono::steady_clock::now() + FLUSH_TIMEOUT};
+    while (isRunning
+           && (ring->tail.load(std::memory_order_acquire) < head)
+           && (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::yield();
+    }
+}
+
+bool LogWriter::checkRateLimit(const void* callSite,
+                               unsigned int& outSuppressedCount)
+{
+    auto now{std::chrono::steady_clock::now()};
+    std::size_t index{(reinterpret_cast<std::uintptr_t>(callSite) >> 3)
+                      % RATE_LIMIT_TABLE_SIZE};
+    RateLimitEntry& entry{threadState.rateLimitTable[index]};
+
+    // If this is a new call site or its window has passed, start a new
+    // window.
+    if ((entry.callSite != callSite)
+        || ((now - entry.windowStart) >= RATE_LIMIT_WINDOW)) {
+        outSuppressedCount
+            = (entry.callSite == callSite) ? entry.suppressedCount : 0;
+        entry = {callSite, now, 1, 0};
+        return true;
+    }
+
+    // If this call site still has room in its window, allow it.
+    if (entry.lineCount < RATE_LIMIT_LINES_PER_WINDOW) {
+        entry.lineCount++;
+        outSuppressedCount = 0;
+        return true;
+    }
+
+    entry.suppressedCount++;
+    return false;
+}
+
+void LogWriter::setLogFile(std::FILE* inLogFile)
+{
+    logFile = inLogFile;
+}
+
+void LogWriter::shutdown()
+{
+    if (!isRunning) {
+        return;
+    }
+
+    // Stop the writer thread.
+    // Note: Later writes will see that we aren't running and write
+    //       synchronously. Writes that are already in progress will drain
+    //       their line themselves (see write()).
+    isRunning = false;
+    exitRequested = true;
+    wakeWriter();
+    if (writerThreadObj.joinable()) {
+        writerThreadObj.join();
+    }
+
+    // Write anything that was pushed while the thread was exiting.
+    drainRings();
+}
+
+LogWriter::Ring* LogWriter::getThreadRing()
+{
+    if (threadState.ring != nullptr) {
+        return threadState.ring;
+    }
+
+    std::unique_lock lock{ringCreationMutex};
+
+    // Try to reuse a ring that was released by an exited thread.
+    std::size_t count{ringCount.load(std::memory_order_acquire)};
+    for (std::size_t i = 0; i < count; ++i) {
+        Ring* ring{rings[i].load(std::memory_order_acquire)};
+        bool expected{false};
+        if (ring->inUse.compare_exchange_strong(expected, true,
+                                                std::memory_order_acq_rel)) {
+            threadState.ring = ring;
+            return ring;
+        }
+    }
+
+    // If there's room, add a new ring.
+    if (count < MAX_RINGS) {
+        Ring* ring{new Ring()};
+        ring->inUse = true;
+        rings[count].store(ring, std::memory_order_release);
+        ringCount.store((count + 1), std::memory_order_release);
+        threadState.ring = ring;
+        return ring;
+    }
+
+    return nullptr;
+}
+
+void LogWriter::writerLoop()
+{
+    while (!exitRequested) {
+        // If there was nothing to write, wait until there is.
+        if (!drainRings()) {
+            std::unique_lock lock{wakeMutex};
+            wakeCondition.wait(lock, [this]() {
+                return (exitRequested || hasQueuedLines()
+                        || (droppedCount.load(std::memory_order_relaxed)
+                            > 0));
+            });
+        }
+    }
+
+    // Write anything that's left.
+    drainRings();
+}
+
+bool LogWriter::hasQueuedLines()
+{
+    std::size_t count{ringCount.load(std::memory_order_acquire)};
+    for (std::size_t i = 0; i < count; ++i) {
+        Ring& ring{*(rings[i].load(std::memory_order_acquire))};
+        if (ring.tail.load(std::memory_order_relaxed) != ring.head.load()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void LogWriter::wakeWriter()
+{
+    // Note: We lock before notifying so that the writer thread can't miss
+    //       it between checking its wait condition and waiting.
+    {
+        std::unique_lock lock{wakeMutex};
+    }
+    wakeCondition.notify_one();
+}
+
+bool LogWriter::drainRings()
+{
+    std::unique_lock lock{writeMutex};
+    bool wroteLines{false};
+    std::size_t count{ringCount.load(std::memory_order_acquire)};
+    for (std::size_t i = 0; i < count; ++i) {
+        Ring& ring{*(rings[i].load(std::memory_order_acquire))};
+        std::size_t tail{ring.tail.load(std::memory_order_relaxed)};
+        std::size_t head{ring.head.load(std::memory_order_acquire)};
+        while (tail != head) {
+            const Line& line{ring.lines[tail % RING_SIZE]};
+            writeLine(line.text.data(), line.length);
+            tail++;
+        }
+
+        if (ring.tail.load(std::memory_order_relaxed) != tail) {
+            // Note: seq_cst, see write().
+            ring.tail.store(tail);
+            wroteLines = true;
+        }
+    }
+
+    // If any lines were dropped, say so.
+    std::size_t dropped{droppedCount.exchange(0, std::memory_order_relaxed)};
+    if (dropped > 0) {
+        char line[MAX_LINE_LENGTH];
+        int length{std::snprintf(line, sizeof(line),
+                                 "Log buffer full, dropped %zu lines.",
+                                 dropped)};
+        writeLine(line, static_cast<std::size_t>(length));
+        wroteLines = true;
+    }
+
+    // Flush once for the whole pass.
+    if (wroteLines) {
+        std::fflush(stdout);
+        if (std::FILE* file{logFile}) {
+            std::fflush(file);
+        }
+    }
+
+    return wroteLines;
+}
+
+void LogWriter::writeLine(const char* line, std::size_t length)
+{
+    if (std::FILE* file{logFile}) {
+        std::fwrite(line, 1, length, file);
+        std::fputc('\n', file);
+    }
+
+    std::fwrite(line, 1, length, stdout);
+    std::fputc('\n', stdout);
+}
+
+void LogWriter::writeSynchronously(const char* line, std::size_t length)
+{
+    std::unique_lock lock{writeMutex};
+    writeLine(line, length);
+    std::fflush(stdout);
+    if (std::FILE* file{logFile}) {
+        std::fflush(file);
+    }
+}
+
+} // End namespace AM
@@ -1,5 +1,8 @@
 #include "PeriodicCaller.h"
 #include "Log.h"
+#include <algorithm>
+#include <string>
+#include <cstdio>
 
 namespace AM
 {
@@ -13,6 +16,10 @@ PeriodicCaller::PeriodicCaller(std::function<void(void)> inGivenFunctNoTimestep,
 , timer{}
 , accumulatedTime{0.0}
 , delayedTimeS{-1}
+, jitterReportPeriodS{-1}
+, jitterReportTimer{}
+, jitterBuckets{}
+, maxJitterS{0}
 {
 }
 
@@ -26,12 +33,17 @@ PeriodicCaller::PeriodicCaller(std::function<void(double)> inGivenFunctTimestep,
 , timer{}
 , accumulatedTime{0.0}
 , delayedTimeS{-1}
+, jitterReportPeriodS{-1}
+, jitterReportTimer{}
+, jitterBuckets{}
+, maxJitterS{0}
 {
 }
 
 void PeriodicCaller::initTimer()
 {
     timer.reset();
+    jitterReportTimer.reset();
 }
 
 void PeriodicCaller::update()
@@ -41,6 +53,11 @@ void PeriodicCaller::update()
 
     // Process as many time steps as have accumulated.
     while (accumulatedTime >= timestepS) {
+        // Track how late this call is starting.
+        if (jitterReportPeriodS > 0) {
+            recordJitter(accumulatedTime - timestepS);
+        }
+
         // Call whichever function we were given on construction.
         if (givenFunctNoTimestep != nullptr) {
             givenFunctNoTimestep();
@@ -52,15 +69,16 @@ void PeriodicCaller::update()
         // Check our execution time.
         double executionTime{timer.getTime()};
         if (executionTime > timestepS) {
-            LOG_INFO("%s overran its update timestep. executionTime: %.5fs",
-                     debugName.c_str(), executionTime);
+            LOG_INFO_RATE_LIMITED(
+                "%s overran its update timestep. executionTime: %.5fs",
+                debugName.c_str(), executionTime);
         }
 
         // Deduct this time step from the accumulator and check for delays.
         accumulatedTime -= timestepS;
         if (accumulatedTime >= timestepS) {
             // Update was delayed for longer than timestepS.
-            LOG_INFO(
+            LOG_INFO_RATE_LIMITED(
                 "Detected a request for multiple %s update calls in the same "
                 "frame. Update was delayed by: %.5fs.",
                 debugName.c_str(), accumulatedTime);
@@ -73,9 +91,10 @@ void PeriodicCaller::update()
         }
         else if ((delayedTimeS > 0) && (accumulatedTime >= delayedTimeS)) {
             // Update was delayed for longer than delayedTimeS.
-            LOG_INFO("%s update missed its ideal call time. Update was delayed "
-                     "by %.5fs.",
-                     debugName.c_str(), accumulatedTime);
+            LOG_INFO_RATE_LIMITED(
+                "%s update missed its ideal call time. Update was delayed by "
+                "%.5fs.",
+                debugName.c_str(), accumulatedTime);
         }
     }
 }
@@ -103,4 +122,48 @@ void PeriodicCaller::reportDelays(double inDelayedTimeS)
     delayedTimeS = inDelayedTimeS;
 }
 
+void PeriodicCaller::reportJitter(double inJitterReportPeriodS)
+{
+    jitterReportPeriodS = inJitterReportPeriodS;
+    jitterReportTimer.reset();
+}
+
+void PeriodicCaller::recordJitter(double latenessS)
+{
+    // Add the lateness to its bucket.
+    auto boundIt{std::upper_bound(JITTER_BUCKET_BOUNDS.begin(),
+                                  JITTER_BUCKET_BOUNDS.end(), latenessS)};
+    jitterBuckets[boundIt - JITTER_BUCKET_BOUNDS.begin()]++;
+    maxJitterS = std::max(maxJitterS, latenessS);
+
+    // If it isn't time to report, return early.
+    if (jitterReportTimer.getTime() < jitterReportPeriodS) {
+        return;
+    }
+
+    // Log the histogram.
+    std::string histogram{};
+    for (std::size_t i = 0; i < jitterBuckets.size(); ++i) {
+        char bucketString[32];
+        if (i < JITTER_BUCKET_BOUNDS.size()) {
+            std::snprintf(bucketString, sizeof(bucketString), "<%.0fus: %u  ",
+                          (JITTER_BUCKET_BOUNDS[i] * 1'000'000),
+                          jitterBuckets[i]);
+        }
+        else {
+            std::snprintf(bucketString, sizeof(bucketString), ">=%.0fus: %u",
+                          (JITTER_BUCKET_BOUNDS.back() * 1'000'000),
+                          jitterBuckets[i]);
+        }
+        histogram += bucketString;
+    }
+    LOG_INFO("%s start time jitter: %s (max: %.0fus)", debugName.c_str(),
+             histogram.c_str(), (maxJitterS * 1'000'000));
+
+    // Reset for the next report.
+    jitterBuckets.fill(0);
+    maxJitterS = 0;
+    jitterReportTimer.reset();
+}
+
 } // namespace AM
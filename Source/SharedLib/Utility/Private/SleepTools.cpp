@@ -0,0 +1,86 @@
+#include "SleepTools.h"
+#if defined(__linux__)
+#include <time.h>
+#include <cerrno>
+#else
+#include "Timer.h"
+#include <SDL_timer.h>
+#endif
+
+namespace AM
+{
+#if defined(__linux__)
+/** The number of nanoseconds in a second. */
+static constexpr long NS_PER_S{1'000'000'000};
+
+/**
+ * Returns the given time, advanced by the given number of seconds.
+ */
+static timespec addSeconds(const timespec& time, double seconds)
+{
+    long long totalNs{static_cast<long long>(time.tv_nsec)
+                      + static_cast<long long>(seconds * NS_PER_S)};
+    timespec result{};
+    result.tv_sec = time.tv_sec + static_cast<time_t>(totalNs / NS_PER_S);
+    result.tv_nsec = static_cast<long>(totalNs % NS_PER_S);
+    return result;
+}
+
+/**
+ * Returns true if lhs is earlier than rhs.
+ */
+static bool isBefore(const timespec& lhs, const timespec& rhs)
+{
+    return (lhs.tv_sec < rhs.tv_sec)
+           || ((lhs.tv_sec == rhs.tv_sec) && (lhs.tv_nsec < rhs.tv_nsec));
+}
+
+void SleepTools::sleepFor(double durationS)
+{
+    if (durationS <= 0) {
+        return;
+    }
+
+    // Calculate our absolute deadline.
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    timespec deadline{addSeconds(now, durationS)};
+
+    // If we have time, sleep until just before the deadline.
+    // Note: Since the wake time is absolute, being interrupted by a signal
+    //       doesn't cause us to drift. We just go back to sleep.
+    if (durationS > SPIN_TIME_S) {
+        timespec wakeTime{addSeconds(now, (durationS - SPIN_TIME_S))};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime,
+                               nullptr)
+               == EINTR) {
+        }
+    }
+
+    // Spin until the deadline.
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    while (isBefore(now, deadline)) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+}
+#else
+void SleepTools::sleepFor(double durationS)
+{
+    if (durationS <= 0) {
+        return;
+    }
+
+    // If we have time, sleep until just before the deadline.
+    Timer timer{};
+    double sleepTimeS{durationS - FALLBACK_SPIN_TIME_S};
+    if (sleepTimeS >= .001) {
+        SDL_Delay(static_cast<Uint32>(sleepTimeS * 1000));
+    }
+
+    // Spin until the deadline.
+    while (timer.getTime() < durationS) {
+    }
+}
+#endif
+
+} // End namespace AM
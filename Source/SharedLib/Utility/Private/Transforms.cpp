@@ -102,6 +102,16 @@ BoundingBox Transforms::modelToWorld(const BoundingBox& modelBounds,
     return movedBox;
 }
 
+BoundingBox Transforms::modelToWorldTile(const BoundingBox& modelBounds,
+                                         const TilePosition& tilePosition)
+{
+    // Place the model-space bounding box at the tile's origin.
+    Position tileOrigin{
+        static_cast<float>(tilePosition.x * SharedConfig::TILE_WORLD_WIDTH),
+        static_cast<float>(tilePosition.y * SharedConfig::TILE_WORLD_WIDTH), 0};
+    return modelToWorld(modelBounds, tileOrigin);
+}
+
 BoundingBox Transforms::modelToWorldCentered(const BoundingBox& modelBounds,
                                              const Position& position)
 {
@@ -20,6 +20,13 @@ namespace AM
 class IDPool
 {
 public:
+    /** Extra room so that we don't run into reuse issues when almost all IDs
+        are reserved.
+        Reserved IDs are always less than (poolSize + SAFETY_BUFFER).
+        Note: If this isn't sufficient, you can just make your pool much
+              larger than the number of IDs you plan on using. */
+    static constexpr unsigned int SAFETY_BUFFER = 100;
+
     IDPool(unsigned int inPoolSize);
 
     /**
@@ -39,12 +46,6 @@ public:
     void freeID(unsigned int ID);
 
 private:
-    /** Extra room so that we don't run into reuse issues when almost all IDs
-        are reserved.
-        Note: If this isn't sufficient, you can just make your pool much
-              larger than the number of IDs you plan on using. */
-    static constexpr unsigned int SAFETY_BUFFER = 100;
-
     /** The maximum number of IDs that we can give out. */
     unsigned int poolSize;
 
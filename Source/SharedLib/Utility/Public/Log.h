@@ -13,6 +13,11 @@
         AM::Log::info(__VA_ARGS__);                                            \
     } while (false)
 
+#define LOG_INFO_RATE_LIMITED(...)                                             \
+    do {                                                                       \
+        AM::Log::infoRateLimited(__VA_ARGS__);                                 \
+    } while (false)
+
 #ifdef NDEBUG
 #define LOG_ERROR(...)                                                         \
     do {                                                                       \
@@ -46,9 +51,13 @@ namespace AM
  *
  * Use LOG_INFO for general printing, LOG_ERROR for recoverable errors (make
  * sure you write appropriate recovery logic), and LOG_FATAL for unrecoverable
- * errors.
+ * errors. Use LOG_INFO_RATE_LIMITED for lines that may repeat every tick
+ * during an incident (dropped messages, missed timesteps, etc).
  * Generally, we'll start error cases as LOG_FATAL, then switch them to
  * LOG_ERROR if there's some expected failure that we can't yet fix.
+ *
+ * Lines are written asynchronously by LogWriter, so logging doesn't block
+ * the calling thread.
  */
 class Log
 {
@@ -57,14 +66,23 @@ public:
         registerCurrentTickPtr(const std::atomic<Uint32>* inCurrentTickPtr);
 
     /**
-     * Prints the given info to stdout (and a file, if enableFileLogging() was
-     * called.), then flushes the buffer.
+     * Queues the given info to be printed to stdout (and a file, if
+     * enableFileLogging() was called).
      */
     static void info(const char* expression, ...);
 
     /**
-     * Prints the given info to stdout (and a file, if enableFileLogging() was
-     * called.), then flushes the buffer.
+     * Like info(), but if this call site (identified by its expression) has
+     * logged too often recently, the line is dropped. The next line that
+     * gets through notes how many were suppressed.
+     */
+    static void infoRateLimited(const char* expression, ...);
+
+    /**
+     * Prints the given info to stdout (and a file, if enableFileLogging()
+     * was called) before returning.
+     * Unlike info(), this never drops the line, even if the log is backed
+     * up.
      */
     static void error(const char* fileName, int line, const char* expression,
                       ...);
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <SDL_stdinc.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace AM
+{
+/**
+ * Writes log lines to stdout (and a log file, if one is set) on a background
+ * thread, so that logging never blocks the thread that's doing it.
+ *
+ * Each thread that logs gets its own fixed-size ring of lines. Pushing a
+ * line into it is a copy and an atomic store, with no locking or allocating.
+ * The writer thread drains every ring, writes the lines, and flushes once
+ * per pass instead of once per line. When there's nothing to write, it
+ * sleeps until a line is pushed into an empty ring.
+ *
+ * If a thread's ring is full, its new lines are dropped and counted, and the
+ * writer thread reports the count. Lines that must not be lost, such as
+ * errors, should use writeSynchronously() instead. Callers can also use
+ * checkRateLimit() to suppress repeated lines before they're even formatted.
+ *
+ * Used by Log, you shouldn't need to use this directly.
+ */
+class LogWriter
+{
+public:
+    /** The max length of a single log line, including the null terminator.
+        Longer lines are truncated. */
+    static constexpr std::size_t MAX_LINE_LENGTH{512};
+
+    /** The number of lines that each thread's ring can hold. */
+    static constexpr std::size_t RING_SIZE{256};
+
+    /** The max number of threads that can have a ring at once. Any further
+        threads fall back to writing synchronously. */
+    static constexpr std::size_t MAX_RINGS{64};
+
+    /** The number of lines that a single call site may log per rate limit
+        window. Any more are suppressed until the next window. */
+    static constexpr unsigned int RATE_LIMIT_LINES_PER_WINDOW{10};
+
+    /** The length of a rate limit window. */
+    static constexpr std::chrono::milliseconds RATE_LIMIT_WINDOW{1000};
+
+    /**
+     * Starts the writer thread.
+     */
+    LogWriter();
+
+    /**
+     * Calls shutdown() and frees the rings.
+     * Note: Must outlive every thread that writes to it. Log never destroys
+     *       its instance, for this reason.
+     */
+    ~LogWriter();
+
+    /**
+     * Queues the given line to be written.
+     *
+     * @param line  The line to write, without a trailing newline.
+     * @param length  The length of line. Will be truncated to
+     *                MAX_LINE_LENGTH - 1.
+     */
+    void write(const char* line, std::size_t length);
+
+    /**
+     * Writes the given line and flushes it before returning, bypassing the
+     * calling thread's ring. Never drops the line.
+     *
+     * Note: Lines that the calling thread previously queued may be written
+     *       after this one. Call flush() first if the order matters.
+     *
+     * @param line  The line to write, without a trailing newline.
+     * @param length  The length of line.
+     */
+    void writeSynchronously(const char* line, std::size_t length);
+
+    /**
+     * Blocks until every line that the calling thread has written so far
+     * has been flushed, or a timeout passes.
+     */
+    void flush();
+
+    /**
+     * Returns true if a line from the given call site should be logged.
+     *
+     * @param callSite  A pointer that identifies the call site, such as its
+     *                  format string.
+     * @param[out] outSuppressedCount  If returning true, set to the number of
+     *                                 lines from this call site that were
+     *                                 suppressed since it was last logged.
+     */
+    bool checkRateLimit(const void* callSite,
+                        unsigned int& outSuppressedCount);
+
+    /**
+     * Sets the file to write to, in addition to stdout. Pass nullptr to
+     * stop writing to a file.
+     */
+    void setLogFile(std::FILE* inLogFile);
+
+    /**
+     * Stops the writer thread after it writes all queued lines. Any later
+     * writes are written synchronously.
+     */
+    void shutdown();
+
+private:
+    /** How long flush() will wait for the writer thread. */
+    static constexpr std::chrono::milliseconds FLUSH_TIMEOUT{1000};
+
+    /** The number of call sites that each thread tracks for rate limiting.
+        Call sites that hash to the same entry share it. */
+    static constexpr std::size_t RATE_LIMIT_TABLE_SIZE{32};
+
+    struct Line {
+        std::array<char, MAX_LINE_LENGTH> text{};
+        std::size_t length{0};
+    };
+
+    /**
+     * A single thread's lines. Single producer (the owning thread), single
+     * consumer (the writer thread).
+     */
+    struct Ring {
+        std::array<Line, RING_SIZE> lines{};
+
+        /** The index of the next line to be pushed. Only written by the
+            producer. */
+        alignas(64) std::atomic<std::size_t> head{0};
+
+        /** The index of the next line to be written. Only written by the
+            writer thread. */
+        alignas(64) std::atomic<std::size_t> tail{0};
+
+        /** If true, a thread owns this ring. When a thread exits, its ring
+            is released so a new thread can reuse it. */
+        std::atomic<bool> inUse{false};
+    };
+
+    /** A call site's rate limiting state. */
+    struct RateLimitEntry {
+        const void* callSite{nullptr};
+        std::chrono::steady_clock::time_point windowStart{};
+        unsigned int lineCount{0};
+        unsigned int suppressedCount{0};
+    };
+
+    /**
+     * Per-thread state. Releases the thread's ring when the thread exits.
+     */
+    struct ThreadState {
+        Ring* ring{nullptr};
+        std::array<RateLimitEntry, RATE_LIMIT_TABLE_SIZE> rateLimitTable{};
+
+        ~ThreadState();
+    };
+
+    /**
+     * Returns the calling thread's ring, claiming one if it doesn't have one
+     * yet. Returns nullptr if there are none left.
+     */
+    Ring* getThreadRing();
+
+    /**
+     * Writer thread function. Drains the rings until exit is requested,
+     * waiting on wakeCondition whenever they're empty.
+     */
+    void writerLoop();
+
+    /**
+     * Returns true if any ring has lines waiting to be written.
+     */
+    bool hasQueuedLines();
+
+    /**
+     * Wakes the writer thread, if it's waiting.
+     */
+    void wakeWriter();
+
+    /**
+     * Writes every queued line, while holding writeMutex.
+     * @return true if any lines were written.
+     */
+    bool drainRings();
+
+    /**
+     * Writes the given line to stdout and the log file, if there is one.
+     * Doesn't flush.
+     */
+    void writeLine(const char* line, std::size_t length);
+
+    static thread_local ThreadState threadState;
+
+    /** Every ring that's been created. Entries in [0, ringCount) are valid.
+        Rings aren't freed when their thread exits, since the writer thread
+        may still be draining them. */
+    std::array<std::atomic<Ring*>, MAX_RINGS> rings;
+    std::atomic<std::size_t> ringCount;
+
+    /** Used when creating rings. */
+    std::mutex ringCreationMutex;
+
+    /** Used to keep synchronous writes from interleaving with the writer
+        thread's writes. Also makes sure that only one thread at a time
+        drains the rings. */
+    std::mutex writeMutex;
+
+    /** Used with wakeCondition. */
+    std::mutex wakeMutex;
+
+    /** Signaled when a line is pushed into an empty ring, or when exit is
+        requested. */
+    std::condition_variable wakeCondition;
+
+    /** The number of lines that were dropped because a ring was full. */
+    std::atomic<std::size_t> droppedCount;
+
+    /** The file to log to, if file logging is enabled. */
+    std::atomic<std::FILE*> logFile;
+
+    /** True while the writer thread is running. */
+    std::atomic<bool> isRunning;
+
+    /** Turn true to signal that the writer thread should end. */
+    std::atomic<bool> exitRequested;
+
+    std::jthread writerThreadObj;
+};
+
+} // End namespace AM
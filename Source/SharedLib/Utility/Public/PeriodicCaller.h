@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Timer.h"
+#include <array>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -75,7 +76,28 @@ public:
      */
     void reportDelays(double inDelayedTimeS);
 
+    /**
+     * Enables periodic logging of a histogram of how late each call of
+     * givenFunct started, relative to its ideal start time.
+     *
+     * @param inJitterReportPeriodS  How often to log the histogram, in
+     *                               seconds.
+     */
+    void reportJitter(double inJitterReportPeriodS);
+
 private:
+    /** The upper bounds (exclusive) of each jitter histogram bucket, in
+        seconds. Calls that are later than the last bound are counted in an
+        extra overflow bucket. */
+    static constexpr std::array<double, 7> JITTER_BUCKET_BOUNDS{
+        .00005, .0001, .00025, .0005, .001, .002, .004};
+
+    /**
+     * Adds the given call lateness to the jitter histogram. If it's time to,
+     * logs the histogram and resets it.
+     */
+    void recordJitter(double latenessS);
+
     /** The function to call every timestepS seconds, if given a callback with
         no arguments. */
     const std::function<void(void)> givenFunctNoTimestep;
@@ -108,6 +130,20 @@ private:
     /** An unreasonable amount of time for the update to be late by.
         If <= 0, no delay reporting will occur. */
     double delayedTimeS;
+
+    /** How often to log the jitter histogram, in seconds.
+        If <= 0, no jitter reporting will occur. */
+    double jitterReportPeriodS;
+
+    /** Used to time when we should log the jitter histogram. */
+    Timer jitterReportTimer;
+
+    /** The number of calls that fell into each bucket since the last jitter
+        report. The last element is the overflow bucket. */
+    std::array<unsigned int, JITTER_BUCKET_BOUNDS.size() + 1> jitterBuckets;
+
+    /** The latest that a call has started since the last jitter report. */
+    double maxJitterS;
 };
 
 } // namespace AM
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * This file contains helper functions for precisely sleeping the current
+ * thread.
+ */
+namespace AM
+{
+class SleepTools
+{
+public:
+    /**
+     * Sleeps the current thread for the given duration, waking up as close to
+     * the end of it as possible.
+     *
+     * On Linux, sleeps until an absolute deadline using clock_nanosleep(),
+     * then spins for the last SPIN_TIME_S to absorb the scheduler's wake-up
+     * latency. Elsewhere, falls back to SDL_Delay() followed by a spin.
+     *
+     * If durationS is less than the spin time, just spins.
+     */
+    static void sleepFor(double durationS);
+
+private:
+    /** How long before the deadline we'll wake up and start spinning.
+        Linux typically wakes a sleeping thread within 50-100us of its
+        deadline, so this leaves some headroom without burning much CPU. */
+    static constexpr double SPIN_TIME_S{.0002};
+
+    /** SDL_Delay() commonly oversleeps by 1-2ms, so on other platforms we
+        need to wake up much earlier. */
+    static constexpr double FALLBACK_SPIN_TIME_S{.003};
+};
+
+} // End namespace AM
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <SDL_stdinc.h>
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <limits>
+#include <cstddef>
+
+namespace AM
+{
+/**
+ * A map from small integer IDs (such as the ones given out by IDPool) to
+ * values, backed by arrays instead of a hash table.
+ *
+ * Each ID indexes directly into an array of slots, so lookups don't need to
+ * hash. Values are kept densely packed, so iteration only visits live
+ * elements. Erasing moves the last element into the erased element's place,
+ * so iteration order isn't stable, and insertions and erasures invalidate
+ * iterators and references.
+ *
+ * Each slot has a generation that's incremented whenever its element is
+ * erased. Code that holds onto an ID can save its generation and check it
+ * later, to detect that the ID was freed and given to someone else in the
+ * meantime.
+ *
+ * The interface mirrors std::unordered_map where it makes sense.
+ */
+template<typename T>
+class SlotMap
+{
+public:
+    /** Elements are stored as (ID, value) pairs. */
+    using value_type = std::pair<Uint32, T>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    /**
+     * @param inCapacity  The number of slots to allocate. Valid IDs are
+     *                    in the range [0, inCapacity).
+     */
+    explicit SlotMap(std::size_t inCapacity)
+    : slots(inCapacity)
+    , elements{}
+    {
+        elements.reserve(inCapacity);
+    }
+
+    /**
+     * If the given ID is valid and not in use, constructs a value for it
+     * from the given args.
+     *
+     * @return An iterator to the element for the given ID (or end() if the
+     *         ID is out of range), and true if a value was constructed.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Uint32 id, Args&&... args)
+    {
+        if (id >= slots.size()) {
+            return {elements.end(), false};
+        }
+
+        Slot& slot{slots[id]};
+        if (slot.elementIndex != INVALID_INDEX) {
+            return {(elements.begin() + slot.elementIndex), false};
+        }
+
+        slot.elementIndex = static_cast<Uint32>(elements.size());
+        elements.emplace_back(
+            std::piecewise_construct, std::forward_as_tuple(id),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return {(elements.end() - 1), true};
+    }
+
+    /**
+     * Returns an iterator to the given ID's element, or end() if it isn't
+     * in use.
+     */
+    iterator find(Uint32 id)
+    {
+        if ((id >= slots.size()) || (slots[id].elementIndex == INVALID_INDEX)) {
+            return elements.end();
+        }
+        return (elements.begin() + slots[id].elementIndex);
+    }
+    const_iterator find(Uint32 id) const
+    {
+        if ((id >= slots.size()) || (slots[id].elementIndex == INVALID_INDEX)) {
+            return elements.end();
+        }
+        return (elements.begin() + slots[id].elementIndex);
+    }
+
+    /**
+     * Returns an iterator to the given ID's element, or end() if it isn't
+     * in use or if its slot's generation doesn't match the given one.
+     */
+    iterator find(Uint32 id, Uint32 generation)
+    {
+        if ((id >= slots.size()) || (slots[id].generation != generation)) {
+            return elements.end();
+        }
+        return find(id);
+    }
+
+    /**
+     * Returns true if the given ID is in use.
+     */
+    bool contains(Uint32 id) const { return (find(id) != elements.end()); }
+
+    /**
+     * Returns the given ID's current generation.
+     * The generation is incremented each time the ID's element is erased.
+     */
+    Uint32 getGeneration(Uint32 id) const
+    {
+        return (id < slots.size()) ? slots[id].generation : 0;
+    }
+
+    /**
+     * Erases the element at the given iterator.
+     *
+     * @return An iterator to the element that took the erased element's
+     *         place, or end() if it was the last element. This lets you
+     *         erase while iterating, the same as std::unordered_map.
+     */
+    iterator erase(iterator it)
+    {
+        std::size_t elementIndex{
+            static_cast<std::size_t>(it - elements.begin())};
+        Slot& erasedSlot{slots[it->first]};
+        erasedSlot.elementIndex = INVALID_INDEX;
+        erasedSlot.generation++;
+
+        // Move the last element into the erased element's place.
+        if (elementIndex != (elements.size() - 1)) {
+            elements[elementIndex] = std::move(elements.back());
+            slots[elements[elementIndex].first].elementIndex
+                = static_cast<Uint32>(elementIndex);
+        }
+        elements.pop_back();
+
+        return (elements.begin() + elementIndex);
+    }
+
+    /**
+     * Erases the given ID's element, if it's in use.
+     *
+     * @return The number of elements that were erased (0 or 1).
+     */
+    std::size_t erase(Uint32 id)
+    {
+        iterator it{find(id)};
+        if (it == elements.end()) {
+            return 0;
+        }
+
+        erase(it);
+        return 1;
+    }
+
+    /** Returns the number of elements. */
+    std::size_t size() const { return elements.size(); }
+
+    /** Returns the number of slots. Valid IDs are less than this. */
+    std::size_t capacity() const { return slots.size(); }
+
+    iterator begin() { return elements.begin(); }
+    iterator end() { return elements.end(); }
+    const_iterator begin() const { return elements.begin(); }
+    const_iterator end() const { return elements.end(); }
+
+private:
+    /** Used to mark a slot as empty. */
+    static constexpr Uint32 INVALID_INDEX{std::numeric_limits<Uint32>::max()};
+
+    struct Slot {
+        /** The index in elements of this slot's element, or INVALID_INDEX if
+            the slot is empty. */
+        Uint32 elementIndex{INVALID_INDEX};
+
+        /** Incremented each time this slot's element is erased. */
+        Uint32 generation{0};
+    };
+
+    /** The slots, indexed by ID. */
+    std::vector<Slot> slots;
+
+    /** The densely packed elements. */
+    std::vector<value_type> elements;
+};
+
+} // End namespace AM
@@ -64,6 +64,13 @@ public:
     static BoundingBox modelToWorld(const BoundingBox& modelBounds,
                                     const Position& position);
 
+    /**
+     * Converts a model-space bounding box to a world-space box, placed on the
+     * given tile.
+     */
+    static BoundingBox modelToWorldTile(const BoundingBox& modelBounds,
+                                        const TilePosition& tilePosition);
+
     /**
      * Converts a model-space bounding box to a world-space box, centered on
      * the given position.
@@ -33,11 +33,15 @@ void WorldSimulation::connect()
     network.connect();
 
     // Wait for the player's ID from the server.
+    // Note: If we're put in the server's join queue, we'll receive position
+    //       updates until we're let in.
     ConnectionResponse connectionResponse{};
-    if (!(connectionResponseQueue.waitPop(connectionResponse,
-                                          CONNECTION_RESPONSE_WAIT_US))) {
-        LOG_FATAL("Server did not respond.");
-    }
+    do {
+        if (!(connectionResponseQueue.waitPop(connectionResponse,
+                                              CONNECTION_RESPONSE_WAIT_US))) {
+            LOG_FATAL("Server did not respond.");
+        }
+    } while (connectionResponse.queuePosition != 0);
 
     // Get our info from the connection response.
     clientEntity = connectionResponse.entity;
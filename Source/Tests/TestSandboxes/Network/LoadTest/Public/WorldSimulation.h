@@ -51,8 +51,9 @@ private:
     void sendNextInput();
 
     /** How long the sim should wait for the server to send a connection
-        response, in microseconds. */
-    static constexpr int CONNECTION_RESPONSE_WAIT_US{1 * 1000 * 1000};
+        response, in microseconds. Must be longer than the server's
+        join queue update period. */
+    static constexpr int CONNECTION_RESPONSE_WAIT_US{2 * 1000 * 1000};
 
     Client::Network& network;
 
@@ -0,0 +1,65 @@
+#include "Network.h"
+#include "IDPool.h"
+#include "Config.h"
+
+namespace AM
+{
+namespace Server
+{
+Network::Network()
+: eventDispatcher{}
+, clientInputRings{Config::MAX_CLIENTS + IDPool::SAFETY_BUFFER}
+, currentTickPtr{nullptr}
+, bytesSentThisTick{0}
+, messagesSentThisTick{0}
+{
+}
+
+void Network::tick()
+{
+    bytesSentThisTick = 0;
+    messagesSentThisTick = 0;
+}
+
+void Network::send(NetworkID, const BinaryBufferSharedPtr& message, Uint32)
+{
+    bytesSentThisTick += message->size();
+    messagesSentThisTick++;
+}
+
+EventDispatcher& Network::getEventDispatcher()
+{
+    return eventDispatcher;
+}
+
+ClientInputRings& Network::getClientInputRings()
+{
+    return clientInputRings;
+}
+
+void Network::setClientAdmitted(NetworkID) {}
+
+void Network::registerCurrentTickPtr(
+    const std::atomic<Uint32>* inCurrentTickPtr)
+{
+    currentTickPtr = inCurrentTickPtr;
+    clientInputRings.registerCurrentTickPtr(inCurrentTickPtr);
+}
+
+Uint32 Network::getCurrentTick()
+{
+    return *currentTickPtr;
+}
+
+std::size_t Network::getBytesSentThisTick() const
+{
+    return bytesSentThisTick;
+}
+
+std::size_t Network::getMessagesSentThisTick() const
+{
+    return messagesSentThisTick;
+}
+
+} // namespace Server
+} // namespace AM
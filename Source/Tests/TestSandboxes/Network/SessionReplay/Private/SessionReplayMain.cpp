@@ -0,0 +1,333 @@
+#include "SDL2pp/SDL.hh"
+#include "SDL2pp/Exception.hh"
+
+#include "Network.h"
+#include "Simulation.h"
+#include "MessageProcessor.h"
+#include "SessionRecorder.h"
+#include "SpriteData.h"
+#include "UserConfig.h"
+#include "ByteTools.h"
+#include "Timer.h"
+#include "Log.h"
+
+#include <exception>
+#include <fstream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <cstdio>
+
+using namespace AM;
+using namespace AM::Server;
+
+/**
+ * Replays a session that was recorded by the server's SessionRecorder.
+ *
+ * The recorded events are fed into a headless Simulation on the same ticks
+ * that they were originally received on, and the time taken by each system
+ * and the number of bytes that it sent are measured. Since sessions are
+ * recorded from server startup, the replay starts at tick 0 and lines up
+ * with the original session.
+ *
+ * Note: The simulation loads the tile map from the working directory, so
+ *       run this from the server's directory. Map saving is disabled, so
+ *       the map files aren't modified and every replay starts from the
+ *       same state.
+ */
+
+/** The stats that we gather for a single tick. */
+struct TickStats {
+    Uint32 tickNum{0};
+    Simulation::SystemTimings systemTimings{};
+    double totalTime{0};
+    std::size_t bytesSent{0};
+    std::size_t messagesSent{0};
+};
+
+void printUsage()
+{
+    std::printf("Usage: SessionReplay <RecordingFile> [CsvOutputFile]\n"
+                "  RecordingFile: A file recorded by the server's "
+                "SessionRecorder.\n"
+                "  CsvOutputFile: Optional, the file to write per-tick stats "
+                "to.\n");
+}
+
+/**
+ * Reads the whole file at the given path into the given buffer.
+ * @return true if successful, else false.
+ */
+bool readFile(const std::string& filePath, std::vector<Uint8>& buffer)
+{
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!(file.is_open())) {
+        return false;
+    }
+
+    std::streamsize fileSize{file.tellg()};
+    file.seekg(0, std::ios::beg);
+    buffer.resize(static_cast<std::size_t>(fileSize));
+    return static_cast<bool>(
+        file.read(reinterpret_cast<char*>(buffer.data()), fileSize));
+}
+
+/**
+ * Pushes the given record into the network's dispatcher or input rings, the
+ * same way that the real network layer would have.
+ */
+void dispatchRecord(Uint8* record, Network& network,
+                    MessageProcessor& messageProcessor)
+{
+    SessionRecorder::RecordType recordType{
+        static_cast<SessionRecorder::RecordType>(record[4])};
+    NetworkID netID{ByteTools::read32(&(record[5]))};
+    MessageType messageType{static_cast<MessageType>(record[9])};
+    Uint16 messageSize{ByteTools::read16(&(record[10]))};
+
+    switch (recordType) {
+        case SessionRecorder::RecordType::Message: {
+            messageProcessor.processReceivedMessage(
+                netID, messageType,
+                (record + SessionRecorder::RECORD_HEADER_SIZE), messageSize);
+            break;
+        }
+        case SessionRecorder::RecordType::ClientConnected: {
+            network.getClientInputRings().resetClient(netID);
+            network.getEventDispatcher().emplace<ClientConnected>(netID);
+            break;
+        }
+        case SessionRecorder::RecordType::ClientDisconnected: {
+            network.getEventDispatcher().emplace<ClientDisconnected>(netID);
+            break;
+        }
+        default: {
+            LOG_FATAL("Invalid record type: %u", record[4]);
+        }
+    }
+}
+
+/**
+ * Logs the mean, 99th percentile, and max of the given values.
+ */
+void logSummary(const char* name, std::vector<double> values,
+                double multiplier, const char* unit)
+{
+    if (values.size() == 0) {
+        return;
+    }
+
+    double sum{0};
+    for (double value : values) {
+        sum += value;
+    }
+    std::sort(values.begin(), values.end());
+    double mean{sum / values.size()};
+    double p99{values[(values.size() * 99) / 100]};
+    double max{values.back()};
+
+    LOG_INFO("%-16s mean: %10.3f%s  p99: %10.3f%s  max: %10.3f%s", name,
+             (mean * multiplier), unit, (p99 * multiplier), unit,
+             (max * multiplier), unit);
+}
+
+/**
+ * Logs a summary of the given stats.
+ */
+void logReport(const std::vector<TickStats>& tickStats)
+{
+    // Gathers one value from each tick.
+    auto gather = [&](auto getValue) {
+        std::vector<double> values{};
+        values.reserve(tickStats.size());
+        for (const TickStats& stats : tickStats) {
+            values.push_back(static_cast<double>(getValue(stats)));
+        }
+        return values;
+    };
+
+    LOG_INFO("Replayed %zu ticks.", tickStats.size());
+    LOG_INFO("System timings, per tick:");
+    logSummary("ClientConnection", gather([](const TickStats& stats) {
+                   return stats.systemTimings.clientConnection;
+               }),
+               1000, "ms");
+    logSummary("TileUpdate", gather([](const TickStats& stats) {
+                   return stats.systemTimings.tileUpdate;
+               }),
+               1000, "ms");
+    logSummary("Input", gather([](const TickStats& stats) {
+                   return stats.systemTimings.input;
+               }),
+               1000, "ms");
+    logSummary("Movement", gather([](const TickStats& stats) {
+                   return stats.systemTimings.movement;
+               }),
+               1000, "ms");
+    logSummary("ClientAOI", gather([](const TickStats& stats) {
+                   return stats.systemTimings.clientAOI;
+               }),
+               1000, "ms");
+    logSummary("MovementSync", gather([](const TickStats& stats) {
+                   return stats.systemTimings.movementSync;
+               }),
+               1000, "ms");
+    logSummary("ChunkStreaming", gather([](const TickStats& stats) {
+                   return stats.systemTimings.chunkStreaming;
+               }),
+               1000, "ms");
+    logSummary("MapSave", gather([](const TickStats& stats) {
+                   return stats.systemTimings.mapSave;
+               }),
+               1000, "ms");
+    logSummary("Total", gather([](const TickStats& stats) {
+                   return stats.totalTime;
+               }),
+               1000, "ms");
+
+    LOG_INFO("Output, per tick:");
+    logSummary("Bytes", gather([](const TickStats& stats) {
+                   return stats.bytesSent;
+               }),
+               1, "B");
+    logSummary("Messages", gather([](const TickStats& stats) {
+                   return stats.messagesSent;
+               }),
+               1, "");
+}
+
+/**
+ * Writes the given stats to a CSV file at the given path, one row per tick.
+ */
+void writeCsv(const std::string& filePath,
+              const std::vector<TickStats>& tickStats)
+{
+    std::FILE* file{std::fopen(filePath.c_str(), "w")};
+    if (file == nullptr) {
+        LOG_ERROR("Failed to open CSV file: %s", filePath.c_str());
+        return;
+    }
+
+    std::fprintf(file, "tick,clientConnectionMs,tileUpdateMs,inputMs,"
+                       "movementMs,clientAOIMs,movementSyncMs,"
+                       "chunkStreamingMs,mapSaveMs,totalMs,bytesSent,"
+                       "messagesSent\n");
+    for (const TickStats& stats : tickStats) {
+        const Simulation::SystemTimings& timings{stats.systemTimings};
+        std::fprintf(file,
+                     "%u,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,"
+                     "%zu,%zu\n",
+                     stats.tickNum, (timings.clientConnection * 1000),
+                     (timings.tileUpdate * 1000), (timings.input * 1000),
+                     (timings.movement * 1000), (timings.clientAOI * 1000),
+                     (timings.movementSync * 1000),
+                     (timings.chunkStreaming * 1000),
+                     (timings.mapSave * 1000), (stats.totalTime * 1000),
+                     stats.bytesSent, stats.messagesSent);
+    }
+
+    std::fclose(file);
+    LOG_INFO("Wrote per-tick stats to %s", filePath.c_str());
+}
+
+int main(int argc, char** argv)
+try {
+    if ((argc < 2) || (argc > 3)) {
+        printUsage();
+        return 1;
+    }
+
+    // Read the recording.
+    std::vector<Uint8> recording{};
+    if (!readFile(argv[1], recording)
+        || (recording.size() < SessionRecorder::FILE_HEADER_SIZE)) {
+        std::printf("Failed to read recording: %s\n", argv[1]);
+        return 1;
+    }
+    Uint16 formatVersion{ByteTools::read16(recording.data())};
+    if (formatVersion != SessionRecorder::FORMAT_VERSION) {
+        std::printf("Unsupported recording format version: %u\n",
+                    formatVersion);
+        return 1;
+    }
+
+    // Set up the SDL constructs.
+    SDL2pp::SDL sdl(0);
+
+    // Initialize the user config.
+    UserConfig::get();
+
+    // Set up the headless server.
+    SpriteData spriteData{};
+    Network network{};
+    Simulation simulation{network, spriteData};
+    MessageProcessor messageProcessor{network.getEventDispatcher(),
+                                      network.getClientInputRings()};
+
+    // Don't save the map. Saves would modify the map files that the next
+    // replay loads, and their timing would vary between runs.
+    simulation.getWorld().tileMap.setSavingEnabled(false);
+
+    // Find the last tick that has a record, so we know when to stop.
+    Uint32 lastRecordTick{0};
+    std::size_t recordCount{0};
+    std::size_t offset{SessionRecorder::FILE_HEADER_SIZE};
+    while ((offset + SessionRecorder::RECORD_HEADER_SIZE)
+           <= recording.size()) {
+        lastRecordTick = ByteTools::read32(&(recording[offset]));
+        Uint16 messageSize{ByteTools::read16(&(recording[offset + 10]))};
+        offset += (SessionRecorder::RECORD_HEADER_SIZE + messageSize);
+        recordCount++;
+    }
+    if (offset != recording.size()) {
+        LOG_INFO("Recording was truncated. Replaying the complete records.");
+    }
+    LOG_INFO("Replaying %zu records over %u ticks.", recordCount,
+             (lastRecordTick + 1));
+
+    // Replay the session.
+    std::vector<TickStats> tickStats{};
+    tickStats.reserve(lastRecordTick + 1);
+    Timer tickTimer{};
+    offset = SessionRecorder::FILE_HEADER_SIZE;
+    for (std::size_t i = 0; i <= lastRecordTick; ++i) {
+        // Push all of the events that were received on this tick.
+        Uint32 currentTick{simulation.getCurrentTick()};
+        while (((offset + SessionRecorder::RECORD_HEADER_SIZE)
+                <= recording.size())
+               && (ByteTools::read32(&(recording[offset])) <= currentTick)) {
+            Uint16 messageSize{ByteTools::read16(&(recording[offset + 10]))};
+            if ((offset + SessionRecorder::RECORD_HEADER_SIZE + messageSize)
+                > recording.size()) {
+                break;
+            }
+
+            dispatchRecord(&(recording[offset]), network, messageProcessor);
+            offset += (SessionRecorder::RECORD_HEADER_SIZE + messageSize);
+        }
+
+        // Run the tick.
+        network.tick();
+        tickTimer.reset();
+        simulation.tick();
+        double tickTime{tickTimer.getTime()};
+
+        tickStats.push_back({currentTick, simulation.getSystemTimings(),
+                             tickTime, network.getBytesSentThisTick(),
+                             network.getMessagesSentThisTick()});
+    }
+
+    logReport(tickStats);
+    if (argc == 3) {
+        writeCsv(argv[2], tickStats);
+    }
+
+    return 0;
+} catch (SDL2pp::Exception& e) {
+    LOG_INFO("Error in: %s  Reason:  %s", e.GetSDLFunction().c_str(),
+             e.GetSDLError().c_str());
+    return 1;
+} catch (std::exception& e) {
+    LOG_INFO("%s", e.what());
+    return 1;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "SharedConfig.h"
+#include "NetworkDefs.h"
+#include "ServerNetworkDefs.h"
+#include "Serialize.h"
+#include "ByteTools.h"
+#include "QueuedEvents.h"
+#include "ClientInputRings.h"
+#include <SDL_stdinc.h>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace AM
+{
+namespace Server
+{
+/**
+ * A headless stand-in for the server's Network.
+ *
+ * Provides the interface that the simulation uses, but never touches a
+ * socket. Sent messages are dropped after their size is counted, so the
+ * replay runner can report how much the simulation would have sent.
+ *
+ * This header shadows ServerLib's Network.h for the replay runner's build.
+ */
+class Network
+{
+public:
+    Network();
+
+    /**
+     * Drops all messages that were sent during the last tick.
+     * Call once per sim tick, after reading getBytesSentThisTick().
+     */
+    void tick();
+
+    /**
+     * Serializes the given message and counts it as sent.
+     * See the real Network::serializeAndSend().
+     */
+    template<typename T>
+    void serializeAndSend(NetworkID networkID, const T& messageStruct,
+                          Uint32 messageTick = 0);
+
+    /**
+     * Serializes the given message into a buffer, with a message header.
+     * See the real Network::serialize().
+     */
+    template<typename T>
+    BinaryBufferSharedPtr serialize(const T& messageStruct);
+
+    /**
+     * Counts the given message as sent.
+     */
+    void send(NetworkID networkID, const BinaryBufferSharedPtr& message,
+              Uint32 messageTick = 0);
+
+    /**
+     * Returns the Network event dispatcher. Replayed events are pushed into
+     * this dispatcher.
+     */
+    EventDispatcher& getEventDispatcher();
+
+    /**
+     * Returns the clients' input rings. Replayed inputs are pushed into
+     * these rings.
+     */
+    ClientInputRings& getClientInputRings();
+
+    /** No-op, we have no clients to time out. */
+    void setClientAdmitted(NetworkID networkID);
+
+    /** Used for passing us a pointer to the Game's currentTick. */
+    void registerCurrentTickPtr(const std::atomic<Uint32>* inCurrentTickPtr);
+
+    /** Convenience for network-owned objects to get the current tick. */
+    Uint32 getCurrentTick();
+
+    /** Returns the number of bytes that were sent since the last tick(). */
+    std::size_t getBytesSentThisTick() const;
+
+    /** Returns the number of messages that were sent since the last
+        tick(). */
+    std::size_t getMessagesSentThisTick() const;
+
+private:
+    /** Used to dispatch events from the network to the simulation. */
+    EventDispatcher eventDispatcher;
+
+    /** Used to pass client inputs to the simulation. */
+    ClientInputRings clientInputRings;
+
+    /** Pointer to the game's current tick. */
+    const std::atomic<Uint32>* currentTickPtr;
+
+    /** The number of bytes that were sent since the last tick(). */
+    std::size_t bytesSentThisTick;
+
+    /** The number of messages that were sent since the last tick(). */
+    std::size_t messagesSentThisTick;
+};
+
+template<typename T>
+void Network::serializeAndSend(NetworkID networkID, const T& messageStruct,
+                               Uint32 messageTick)
+{
+    send(networkID, serialize(messageStruct), messageTick);
+}
+
+template<typename T>
+BinaryBufferSharedPtr Network::serialize(const T& messageStruct)
+{
+    // Allocate the buffer.
+    std::size_t totalMessageSize{MESSAGE_HEADER_SIZE
+                                 + Serialize::measureSize(messageStruct)};
+    BinaryBufferSharedPtr messageBuffer{
+        std::make_shared<BinaryBuffer>(totalMessageSize)};
+
+    // Serialize the message struct into the buffer, leaving room for the
+    // header.
+    std::size_t messageSize{
+        Serialize::toBuffer(messageBuffer->data(), messageBuffer->size(),
+                            messageStruct, MESSAGE_HEADER_SIZE)};
+
+    // Fill in the header.
+    messageBuffer->at(MessageHeaderIndex::MessageType)
+        = static_cast<Uint8>(T::MESSAGE_TYPE);
+    ByteTools::write16(static_cast<Uint16>(messageSize),
+                       (messageBuffer->data() + MessageHeaderIndex::Size));
+
+    return messageBuffer;
+}
+
+} // namespace Server
+} // namespace AM
@@ -0,0 +1,75 @@
+#include "catch2/catch_all.hpp"
+#include "MovementHelpers.h"
+#include "MovementBatch.h"
+#include "Input.h"
+#include "Position.h"
+#include "Velocity.h"
+#include "Rotation.h"
+#include "SharedConfig.h"
+#include <cstring>
+#include <vector>
+
+using namespace AM;
+
+namespace
+{
+/** Returns true if the two floats have the same bit pattern. */
+bool bitsEqual(float lhs, float rhs)
+{
+    return (std::memcmp(&lhs, &rhs, sizeof(float)) == 0);
+}
+} // namespace
+
+TEST_CASE("TestMovementHelpers")
+{
+    SECTION("Batch update matches scalar update")
+    {
+        // Build every combination of the X and Y inputs, at a few starting
+        // positions and rotations.
+        std::vector<Input> inputs{};
+        std::vector<Position> positions{};
+        std::vector<Velocity> velocities{};
+        std::vector<Rotation> rotations{};
+        const std::vector<Position> startPositions{
+            {0, 0, 0}, {123.456f, -78.9f, 0}, {16383.99f, 0.001f, 0}};
+        for (const Position& startPosition : startPositions) {
+            for (unsigned int inputBits = 0; inputBits < 16; ++inputBits) {
+                Input input{};
+                for (unsigned int type = 0; type < 4; ++type) {
+                    if (inputBits & (1 << type)) {
+                        input.inputStates[type] = Input::Pressed;
+                    }
+                }
+                inputs.push_back(input);
+                positions.push_back(startPosition);
+                velocities.push_back({1.5f, -2.5f, 0});
+                rotations.push_back(
+                    {static_cast<Rotation::Direction>((inputBits % 9) - 4)});
+            }
+        }
+
+        MovementBatch batch{};
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            batch.push(static_cast<entt::entity>(i), inputs[i], positions[i],
+                       velocities[i], rotations[i]);
+        }
+        MovementHelpers::updateBatch(batch, SharedConfig::SIM_TICK_TIMESTEP_S);
+
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            Velocity velocity{MovementHelpers::updateVelocity(
+                velocities[i], inputs[i].inputStates,
+                SharedConfig::SIM_TICK_TIMESTEP_S)};
+            Position position{MovementHelpers::updatePosition(
+                positions[i], velocity, SharedConfig::SIM_TICK_TIMESTEP_S)};
+            Rotation rotation{MovementHelpers::updateRotation(
+                rotations[i], inputs[i].inputStates)};
+
+            REQUIRE(bitsEqual(batch.velocityXs[i], velocity.x));
+            REQUIRE(bitsEqual(batch.velocityYs[i], velocity.y));
+            REQUIRE(bitsEqual(batch.positionXs[i], position.x));
+            REQUIRE(bitsEqual(batch.positionYs[i], position.y));
+            REQUIRE(batch.directions[i]
+                    == static_cast<int>(rotation.direction));
+        }
+    }
+}
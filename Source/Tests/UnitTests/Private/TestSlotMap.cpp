@@ -0,0 +1,96 @@
+#include "catch2/catch_all.hpp"
+#include "SlotMap.h"
+#include <string>
+
+using namespace AM;
+
+TEST_CASE("TestSlotMap")
+{
+    SECTION("Emplace and find")
+    {
+        SlotMap<std::string> slotMap{10};
+        REQUIRE(slotMap.try_emplace(3, "three").second);
+        REQUIRE(slotMap.try_emplace(7, "seven").second);
+        REQUIRE(slotMap.size() == 2);
+
+        auto it{slotMap.find(3)};
+        REQUIRE(it != slotMap.end());
+        REQUIRE(it->first == 3);
+        REQUIRE(it->second == "three");
+        REQUIRE(slotMap.contains(7));
+        REQUIRE(!(slotMap.contains(5)));
+
+        // Emplacing an existing ID doesn't replace its value.
+        auto [existingIt, wasEmplaced]{slotMap.try_emplace(3, "other")};
+        REQUIRE(!wasEmplaced);
+        REQUIRE(existingIt->second == "three");
+
+        // Out of range IDs are rejected.
+        REQUIRE(!(slotMap.try_emplace(10, "ten").second));
+        REQUIRE(slotMap.find(10) == slotMap.end());
+    }
+
+    SECTION("Erase keeps the remaining elements reachable")
+    {
+        SlotMap<int> slotMap{10};
+        for (Uint32 id = 0; id < 5; ++id) {
+            slotMap.try_emplace(id, static_cast<int>(id * 10));
+        }
+
+        // Erase an element from the middle, so the last one is moved.
+        REQUIRE(slotMap.erase(1) == 1);
+        REQUIRE(slotMap.erase(1) == 0);
+        REQUIRE(slotMap.size() == 4);
+        REQUIRE(!(slotMap.contains(1)));
+        for (Uint32 id : {0, 2, 3, 4}) {
+            auto it{slotMap.find(id)};
+            REQUIRE(it != slotMap.end());
+            REQUIRE(it->second == static_cast<int>(id * 10));
+        }
+
+        // Iteration only visits live elements.
+        int sum{0};
+        for (auto& [id, value] : slotMap) {
+            sum += value;
+        }
+        REQUIRE(sum == (0 + 20 + 30 + 40));
+    }
+
+    SECTION("Erase while iterating")
+    {
+        SlotMap<int> slotMap{10};
+        for (Uint32 id = 0; id < 6; ++id) {
+            slotMap.try_emplace(id, static_cast<int>(id));
+        }
+
+        // Erase the even values.
+        for (auto it = slotMap.begin(); it != slotMap.end();) {
+            if ((it->second % 2) == 0) {
+                it = slotMap.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        REQUIRE(slotMap.size() == 3);
+        REQUIRE(slotMap.contains(1));
+        REQUIRE(slotMap.contains(3));
+        REQUIRE(slotMap.contains(5));
+    }
+
+    SECTION("Generation detects reuse")
+    {
+        SlotMap<int> slotMap{10};
+        slotMap.try_emplace(4, 1);
+        Uint32 generation{slotMap.getGeneration(4)};
+        REQUIRE(slotMap.find(4, generation) != slotMap.end());
+
+        // Free and re-use the ID.
+        slotMap.erase(4);
+        slotMap.try_emplace(4, 2);
+        REQUIRE(slotMap.getGeneration(4) != generation);
+        REQUIRE(slotMap.find(4, generation) == slotMap.end());
+        REQUIRE(slotMap.find(4, slotMap.getGeneration(4))->second == 2);
+    }
+}